@@ -0,0 +1,39 @@
+#include "AppleFlowField.h"
+
+#include "GameState.h"
+
+void AppleFlowField::Update( const GameState& gameState ) {
+	if ( m_Tick == gameState.Tick && m_Distances.size() == gameState.Board.size() ) {
+		return;
+	}
+	m_Tick		= gameState.Tick;
+	m_Distances.assign( gameState.Board.size(), NO_FLOW );
+	m_NextTiles.assign( gameState.Board.size(), NO_FLOW );
+	m_Queue.resize( gameState.Board.size() );		// Every tile is queued at most once.
+
+	// Every apple starts the search at distance zero.
+	size_t queueEnd		= 0;
+	for ( const auto& apple : gameState.Apples ) {
+		const uint32_t tile		= static_cast<uint32_t>( gameState.GetTileIndex( apple ) );
+		m_Distances[tile]		= 0;
+		m_NextTiles[tile]		= tile;
+		m_Queue[queueEnd++]		= tile;
+	}
+
+	const int stride					= static_cast<int>( gameState.BoardStride );
+	const int neighbourOffsets[4]		= { -stride, -1, 1, stride };
+	for ( size_t queueBegin = 0; queueBegin < queueEnd; ++queueBegin ) {
+		const uint32_t tile		= m_Queue[queueBegin];
+		for ( int offset : neighbourOffsets ) {
+			const uint32_t neighbour		= static_cast<uint32_t>( static_cast<int>( tile ) + offset );		// Only open tiles are queued, so the blocked border keeps neighbours on the board.
+			if ( m_Distances[neighbour] != NO_FLOW ) {
+				continue;
+			}
+			m_Distances[neighbour]		= m_Distances[tile] + 1;
+			m_NextTiles[neighbour]		= tile;
+			if ( !gameState.IsTileBlockedBit( neighbour ) ) {
+				m_Queue[queueEnd++]		= neighbour;
+			}
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define NO_FLOW		UINT32_MAX		// Distance and next tile of tiles that no apple can be reached from.
+
+class GameState;
+
+// Distance to the closest apple and the first tile on the way there, for every tile on the board. Found with one breadth first search from all the apples at once,
+// so a snake looks up its way to an apple instead of searching for it. Apples and obstacles are the same for everyone, so one field serves all teams.
+// Blocked tiles next to reached tiles get a distance too, but the search doesn't pass through them. That way the heads of snakes, which are blocked, have a way to an apple.
+class AppleFlowField {
+public:
+								// Rebuilds the field for the board as it is now. Does nothing if it was already built at the states tick.
+	void						Update					( const GameState& gameState );
+
+								// Number of moves from the tile to the closest apple, or NO_FLOW.
+	uint32_t					GetDistance				( size_t tileIndex ) const;
+								// Board index of the neighbour to move to from the tile, the tile itself for apples, or NO_FLOW.
+	uint32_t					GetNextTile				( size_t tileIndex ) const;
+
+private:
+	std::vector<uint32_t>		m_Distances;									// One entry per tile of the board.
+	std::vector<uint32_t>		m_NextTiles;									// One entry per tile of the board.
+	std::vector<uint32_t>		m_Queue;										// Search queue, keeps its capacity between updates.
+	uint32_t					m_Tick					= NO_FLOW;				// Tick the field was built at, NO_FLOW before the first update.
+};
+
+inline uint32_t AppleFlowField::GetDistance( size_t tileIndex ) const {
+	return m_Distances[tileIndex];
+}
+
+inline uint32_t AppleFlowField::GetNextTile( size_t tileIndex ) const {
+	return m_NextTiles[tileIndex];
+}
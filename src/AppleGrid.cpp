@@ -0,0 +1,121 @@
+#include "AppleGrid.h"
+
+#include <cfloat>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+void AppleGrid::Reset( const glm::uvec2& boardSize, const std::vector<glm::ivec2>& apples ) {
+	m_GridSize		= ( glm::ivec2( boardSize ) + APPLE_GRID_CELL_SIZE - 1 ) / APPLE_GRID_CELL_SIZE;		// Rounded up so that every tile is in a cell.
+	m_CellFirstApple.assign( m_GridSize.x * m_GridSize.y, NO_APPLE );
+	m_NextApple.assign( apples.size(), NO_APPLE );
+	m_PreviousApple.assign( apples.size(), NO_APPLE );
+
+	// Insert in reverse so that each cells list ends up in increasing apple index order.
+	for ( size_t appleIndex = apples.size(); appleIndex-- > 0; ) {
+		this->Insert( static_cast<uint32_t>( appleIndex ), apples[appleIndex] );
+	}
+}
+
+void AppleGrid::Insert( uint32_t appleIndex, const glm::ivec2& apple ) {
+	if ( appleIndex >= m_NextApple.size() ) {
+		m_NextApple.resize( appleIndex + 1, NO_APPLE );
+		m_PreviousApple.resize( appleIndex + 1, NO_APPLE );
+	}
+
+	// Link the apple in first in its cell.
+	uint32_t& firstApple			= m_CellFirstApple[GetCellIndex( GetCell( apple ) )];
+	m_NextApple[appleIndex]			= firstApple;
+	m_PreviousApple[appleIndex]		= NO_APPLE;
+	if ( firstApple != NO_APPLE ) {
+		m_PreviousApple[firstApple]		= appleIndex;
+	}
+	firstApple						= appleIndex;
+}
+
+void AppleGrid::Remove( uint32_t appleIndex, const glm::ivec2& apple ) {
+	const uint32_t next			= m_NextApple[appleIndex];
+	const uint32_t previous		= m_PreviousApple[appleIndex];
+	if ( previous != NO_APPLE ) {
+		m_NextApple[previous]		= next;
+	} else {
+		m_CellFirstApple[GetCellIndex( GetCell( apple ) )]		= next;
+	}
+	if ( next != NO_APPLE ) {
+		m_PreviousApple[next]		= previous;
+	}
+	m_NextApple[appleIndex]			= NO_APPLE;
+	m_PreviousApple[appleIndex]		= NO_APPLE;
+}
+
+uint32_t AppleGrid::FindAppleAt( const std::vector<glm::ivec2>& apples, const glm::ivec2& tile ) const {
+	for ( uint32_t appleIndex = m_CellFirstApple[GetCellIndex( GetCell( tile ) )]; appleIndex != NO_APPLE; appleIndex = m_NextApple[appleIndex] ) {
+		if ( apples[appleIndex] == tile ) {
+			return appleIndex;
+		}
+	}
+	return NO_APPLE;
+}
+
+uint32_t AppleGrid::FindClosest( const std::vector<glm::ivec2>& apples, const glm::vec2& position, float maxDistance ) const {
+	const glm::ivec2 centerCell		= GetCell( position );
+	const int maxRing				= glm::max( glm::max( centerCell.x, m_GridSize.x - 1 - centerCell.x ), glm::max( centerCell.y, m_GridSize.y - 1 - centerCell.y ) );
+	uint32_t closestApple			= NO_APPLE;
+	float closestDistanceSqrd		= maxDistance < FLT_MAX ? maxDistance * maxDistance : FLT_MAX;
+
+	// Search square rings of cells around the position's cell, moving outwards.
+	for ( int ring = 0; ring <= maxRing; ++ring ) {
+		// Apples in this ring or further out are at least ( ring - 1 ) cells away from the position, stop once that is further than the closest apple found.
+		// Equal distances keep searching, so that ties resolve the same way no matter which cell the apples are in.
+		const float ringDistance		= static_cast<float>( ( ring - 1 ) * APPLE_GRID_CELL_SIZE );
+		if ( ring > 1 && ringDistance * ringDistance > closestDistanceSqrd ) {
+			break;
+		}
+
+		for ( int cellY = centerCell.y - ring; cellY <= centerCell.y + ring; ++cellY ) {
+			if ( cellY < 0 || cellY >= m_GridSize.y ) {
+				continue;
+			}
+			const bool isEdgeRow		= cellY == centerCell.y - ring || cellY == centerCell.y + ring;
+			const int stepX				= isEdgeRow ? 1 : glm::max( 2 * ring, 1 );		// Rows between the top and bottom edge only have the left and right cell in the ring.
+			for ( int cellX = centerCell.x - ring; cellX <= centerCell.x + ring; cellX += stepX ) {
+				if ( cellX < 0 || cellX >= m_GridSize.x ) {
+					continue;
+				}
+
+				for ( uint32_t appleIndex = m_CellFirstApple[GetCellIndex( glm::ivec2( cellX, cellY ) )]; appleIndex != NO_APPLE; appleIndex = m_NextApple[appleIndex] ) {
+					const glm::vec2 vectorToApple		= glm::vec2( apples[appleIndex] ) - position;
+					const float distanceToAppleSqrd		= glm::dot( vectorToApple, vectorToApple );
+					if ( distanceToAppleSqrd < closestDistanceSqrd || ( distanceToAppleSqrd == closestDistanceSqrd && appleIndex < closestApple ) ) {
+						closestDistanceSqrd		= distanceToAppleSqrd;
+						closestApple			= appleIndex;
+					}
+				}
+			}
+		}
+	}
+	return closestApple;
+}
+
+void AppleGrid::FindWithin( const std::vector<glm::ivec2>& apples, const glm::vec2& position, float radius, std::vector<uint32_t>& outAppleIndices ) const {
+	const glm::ivec2 minCell		= GetCell( position - glm::vec2( radius ) );
+	const glm::ivec2 maxCell		= GetCell( position + glm::vec2( radius ) );
+	for ( int cellY = minCell.y; cellY <= maxCell.y; ++cellY ) {
+		for ( int cellX = minCell.x; cellX <= maxCell.x; ++cellX ) {
+			for ( uint32_t appleIndex = m_CellFirstApple[GetCellIndex( glm::ivec2( cellX, cellY ) )]; appleIndex != NO_APPLE; appleIndex = m_NextApple[appleIndex] ) {
+				const glm::vec2 vectorToApple		= glm::vec2( apples[appleIndex] ) - position;
+				if ( glm::dot( vectorToApple, vectorToApple ) <= radius * radius ) {
+					outAppleIndices.push_back( appleIndex );
+				}
+			}
+		}
+	}
+}
+
+glm::ivec2 AppleGrid::GetCell( const glm::vec2& position ) const {
+	const glm::ivec2 cell		= glm::ivec2( glm::floor( position / static_cast<float>( APPLE_GRID_CELL_SIZE ) ) );
+	return glm::clamp( cell, glm::ivec2( 0 ), m_GridSize - 1 );		// Positions outside of the board are searched from the closest cell.
+}
+
+size_t AppleGrid::GetCellIndex( const glm::ivec2& cell ) const {
+	return cell.y * m_GridSize.x + cell.x;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <vector>
+
+#define APPLE_GRID_CELL_SIZE		8				// Width and height in tiles of each cell in the grid.
+#define NO_APPLE					UINT32_MAX		// Returned by queries that find no apple.
+
+// Spatial index over the apples of a game state. The board is divided into square cells, each holding a linked list of the apples inside it.
+// Apples are referred to by their index in the apple array, which is passed to the queries so that positions are not stored twice.
+// All storage is flat arrays, so copying the grid along with its state is cheap.
+class AppleGrid {
+public:
+	void						Reset					( const glm::uvec2& boardSize, const std::vector<glm::ivec2>& apples );
+	void						Insert					( uint32_t appleIndex, const glm::ivec2& apple );
+	void						Remove					( uint32_t appleIndex, const glm::ivec2& apple );
+
+								// Returns the index of the apple on the tile, or NO_APPLE.
+	uint32_t					FindAppleAt				( const std::vector<glm::ivec2>& apples, const glm::ivec2& tile ) const;
+								// Returns the index of the closest apple no further away than maxDistance, or NO_APPLE. Ties go to the lowest apple index.
+	uint32_t					FindClosest				( const std::vector<glm::ivec2>& apples, const glm::vec2& position, float maxDistance ) const;
+								// Appends the index of every apple within radius of the position.
+	void						FindWithin				( const std::vector<glm::ivec2>& apples, const glm::vec2& position, float radius, std::vector<uint32_t>& outAppleIndices ) const;
+
+private:
+	glm::ivec2					GetCell					( const glm::vec2& position ) const;
+	size_t						GetCellIndex			( const glm::ivec2& cell ) const;
+
+	glm::ivec2					m_GridSize				= glm::ivec2( 0 );		// Number of cells in each direction.
+	std::vector<uint32_t>		m_CellFirstApple;								// First apple in each cells list, or NO_APPLE.
+	std::vector<uint32_t>		m_NextApple;									// Next apple in the same cell, per apple.
+	std::vector<uint32_t>		m_PreviousApple;								// Previous apple in the same cell, per apple.
+};
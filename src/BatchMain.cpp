@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "BatchRunner.h"
+
+#define DEFAULT_NR_OF_GAMES			1000
+#define DEFAULT_MAX_TICKS			100000		// Upper limit on ticks so that a stalemate doesn't run forever.
+#define DEFAULT_FIRST_SEED			1
+
+// Plays a batch of seeded games on all cores and reports the results.
+// Usage: SnakeBatch [nrOfGames] [nrOfThreads] [maxTicks] [firstSeed] [teamPlayers] [timeBudgetMs], zero threads uses one per hardware thread.
+// The time budget is per tick and team for the players that search, M and S. Zero, the default, has them search a fixed amount, so that results only depend on the seeds.
+// Team players is one letter per team, B for Boids, A for A*, J for Jump Point Search, C for cooperative A*, D for D* Lite, H for hierarchical A*, M for Monte Carlo tree search and S for adversarial search, for example "BABA".
+int main( int argc, char** argv ) {
+	const size_t nrOfGames		= argc > 1 ? static_cast<size_t>( std::strtoull( argv[1], nullptr, 10 ) ) : DEFAULT_NR_OF_GAMES;
+	const size_t nrOfThreads	= argc > 2 ? static_cast<size_t>( std::strtoull( argv[2], nullptr, 10 ) ) : 0;
+	const size_t maxTicks		= argc > 3 ? static_cast<size_t>( std::strtoull( argv[3], nullptr, 10 ) ) : DEFAULT_MAX_TICKS;
+	const uint64_t firstSeed	= argc > 4 ? std::strtoull( argv[4], nullptr, 10 ) : DEFAULT_FIRST_SEED;
+	PlayerSettings playerSettings;
+	playerSettings.TimeBudgetMs	= argc > 6 ? std::strtod( argv[6], nullptr ) : 0.0;
+	std::vector<PlayerType> teamPlayers;
+	if ( !ParseTeamPlayers( argc > 5 ? argv[5] : DEFAULT_TEAM_PLAYERS, teamPlayers ) ) {
+		std::fprintf( stderr, "Invalid team players \"%s\", use one letter per team for up to %d teams: B (Boids), A (A*), J (Jump Point Search), C (cooperative A*), D (D* Lite), H (hierarchical A*), M (Monte Carlo tree search) or S (adversarial search).\n", argv[5], MAX_NR_OF_TEAMS );
+		return 1;
+	}
+
+	BatchRunner batchRunner( nrOfThreads );
+	std::vector<GameResult> results( nrOfGames );
+
+	const auto startTime		= std::chrono::steady_clock::now();
+	batchRunner.Run( firstSeed, maxTicks, teamPlayers, playerSettings, results );
+	const std::chrono::duration<double> elapsed		= std::chrono::steady_clock::now() - startTime;
+
+	// Aggregate the results of all games.
+	size_t totalTicks		= 0;
+	size_t nrOfDraws		= 0;
+	std::vector<size_t> wins;
+	std::vector<TeamResult> teamTotals;
+	for ( const auto& result : results ) {
+		totalTicks		+= result.Ticks;
+		wins.resize( result.Teams.size() );
+		teamTotals.resize( result.Teams.size() );
+		if ( result.Winner == NO_WINNER ) {
+			++nrOfDraws;
+		} else {
+			++wins[result.Winner];
+		}
+		for ( size_t teamIndex = 0; teamIndex < result.Teams.size(); ++teamIndex ) {
+			teamTotals[teamIndex].ApplesEaten		+= result.Teams[teamIndex].ApplesEaten;
+			teamTotals[teamIndex].TicksSurvived		+= result.Teams[teamIndex].TicksSurvived;
+			teamTotals[teamIndex].FinalLength		+= result.Teams[teamIndex].FinalLength;
+		}
+	}
+
+	const double gameCount		= nrOfGames > 0 ? static_cast<double>( nrOfGames ) : 1.0;
+	std::printf( "Games:        %zu (%zu threads)\n",	nrOfGames, batchRunner.GetNrOfThreads() );
+	std::printf( "Time:         %.3f s\n",				elapsed.count() );
+	std::printf( "Games/sec:    %.1f\n",				elapsed.count() > 0.0 ? nrOfGames / elapsed.count() : 0.0 );
+	std::printf( "Ticks/sec:    %.1f\n",				elapsed.count() > 0.0 ? totalTicks / elapsed.count() : 0.0 );
+	std::printf( "Avg ticks:    %.1f\n",				totalTicks / gameCount );
+	std::printf( "No winner:    %zu\n",					nrOfDraws );
+	for ( size_t teamIndex = 0; teamIndex < teamTotals.size(); ++teamIndex ) {
+		std::printf( "Team %zu:       %zu wins, avg %.1f apples, avg %.1f ticks survived, avg final length %.1f\n",
+			teamIndex + 1, wins[teamIndex], teamTotals[teamIndex].ApplesEaten / gameCount, teamTotals[teamIndex].TicksSurvived / gameCount, teamTotals[teamIndex].FinalLength / gameCount );
+	}
+
+	return 0;	// Exit success.
+}
@@ -0,0 +1,39 @@
+#include "BatchRunner.h"
+
+BatchRunner::BatchRunner( size_t nrOfThreads ) : m_Pool( nrOfThreads ) {
+}
+
+size_t BatchRunner::GetNrOfThreads() const {
+	return m_Pool.GetNrOfThreads();
+}
+
+void BatchRunner::Run( uint64_t firstSeed, size_t maxTicks, const std::vector<PlayerType>& teamPlayers, const PlayerSettings& playerSettings, std::vector<GameResult>& outResults ) {
+	m_Pool.Run( outResults.size(), [&]( size_t gameIndex, size_t ) {
+		this->PlayGame( firstSeed + gameIndex, maxTicks, teamPlayers, playerSettings, outResults[gameIndex] );		// Every game writes to its own result, so no locking is needed.
+	} );
+}
+
+void BatchRunner::PlayGame( uint64_t seed, size_t maxTicks, const std::vector<PlayerType>& teamPlayers, const PlayerSettings& playerSettings, GameResult& outResult ) const {
+	// The batch already plays a game per thread, so the players search on the thread of their game.
+	PlayerSettings gameSettings		= playerSettings;
+	gameSettings.NrOfThreads		= 1;
+	Game game( seed, teamPlayers, gameSettings );
+	while ( game.GetTick() < maxTicks && game.GetNrOfTeamsAlive() > 1 ) {
+		game.Update();
+	}
+
+	const std::vector<TeamData>& teamDatas		= game.GetTeamDatas();
+	outResult.Seed		= seed;
+	outResult.Ticks		= game.GetTick();
+	outResult.Winner	= NO_WINNER;
+	outResult.Teams.resize( teamDatas.size() );
+	for ( size_t teamIndex = 0; teamIndex < teamDatas.size(); ++teamIndex ) {
+		TeamResult& teamResult			= outResult.Teams[teamIndex];
+		teamResult.ApplesEaten			= teamDatas[teamIndex].ApplesEaten;
+		teamResult.TicksSurvived		= teamDatas[teamIndex].TicksSurvived;
+		teamResult.FinalLength			= game.GetTeamLength( teamIndex );
+		if ( game.GetNrOfTeamsAlive() == 1 && !game.GetState().Teams[teamIndex].Snakes.empty() ) {
+			outResult.Winner		= static_cast<int>( teamIndex );
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Game.h"
+#include "WorkStealingPool.h"
+
+#define NO_WINNER		-1		// Winner of games where every team died, or more than one team was alive when the tick limit was reached.
+
+struct TeamResult {
+	size_t						ApplesEaten				= 0;
+	size_t						TicksSurvived			= 0;
+	size_t						FinalLength				= 0;
+};
+
+struct GameResult {
+	uint64_t					Seed					= 0;
+	size_t						Ticks					= 0;
+	int							Winner					= NO_WINNER;
+	std::vector<TeamResult>		Teams;
+};
+
+// Plays many independent games in parallel, one game per task on a work stealing pool.
+class BatchRunner {
+public:
+	explicit					BatchRunner				( size_t nrOfThreads = 0 );		// Zero uses one thread per hardware thread.
+
+	size_t						GetNrOfThreads			( ) const;
+
+								// Plays outResults.size() games, seeded firstSeed, firstSeed + 1 and so on. Each game runs until at most one team is left or maxTicks is reached.
+								// The players run on the thread of their game, whatever number of threads the settings ask for.
+	void						Run						( uint64_t firstSeed, size_t maxTicks, const std::vector<PlayerType>& teamPlayers, const PlayerSettings& playerSettings, std::vector<GameResult>& outResults );
+	void						PlayGame				( uint64_t seed, size_t maxTicks, const std::vector<PlayerType>& teamPlayers, const PlayerSettings& playerSettings, GameResult& outResult ) const;
+
+private:
+	WorkStealingPool			m_Pool;
+};
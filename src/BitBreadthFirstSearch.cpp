@@ -0,0 +1,169 @@
+#include "BitBreadthFirstSearch.h"
+
+#include <algorithm>
+#include "GameState.h"
+
+void BitBreadthFirstSearch::Reset( const GameState& gameState ) {
+	// Only the words the last search left set are cleared, unless the board changed size.
+	if ( m_Frontier.size() != gameState.BlockedBits.size() ) {
+		m_Reached.assign( gameState.BlockedBits.size(), 0 );
+		m_Frontier.assign( gameState.BlockedBits.size(), 0 );
+		m_PreviousFrontier.assign( gameState.BlockedBits.size(), 0 );
+	} else {
+		std::fill( m_Reached.begin() + std::min( m_FirstReachedWord, m_EndReachedWord ), m_Reached.begin() + m_EndReachedWord, 0 );
+		std::fill( m_Frontier.begin() + std::min( m_FirstWord, m_EndWord ), m_Frontier.begin() + m_EndWord, 0 );
+		std::fill( m_PreviousFrontier.begin() + std::min( m_PreviousFirstWord, m_PreviousEndWord ), m_PreviousFrontier.begin() + m_PreviousEndWord, 0 );
+	}
+	m_Blocked				= gameState.BlockedBits.data();
+	m_NrOfTiles				= gameState.Board.size();
+	m_FirstWord				= m_Frontier.size();
+	m_EndWord				= 0;
+	m_PreviousFirstWord		= 0;
+	m_PreviousEndWord		= 0;
+	m_FirstReachedWord		= m_Frontier.size();
+	m_EndReachedWord		= 0;
+	m_RowWords				= gameState.BoardStride / BITS_PER_WORD;
+	m_RowBits				= static_cast<int>( gameState.BoardStride % BITS_PER_WORD );
+	m_Level					= 0;
+}
+
+void BitBreadthFirstSearch::AddSource( size_t tileIndex ) {
+	const size_t wordIndex		= tileIndex / BITS_PER_WORD;
+	const uint64_t tileBit		= uint64_t( 1 ) << ( tileIndex % BITS_PER_WORD );
+	m_Reached[wordIndex]		|= tileBit;
+	m_Frontier[wordIndex]		|= tileBit;
+	m_FirstWord					= std::min( m_FirstWord, wordIndex );
+	m_EndWord					= std::max( m_EndWord, wordIndex + 1 );
+	m_FirstReachedWord			= std::min( m_FirstReachedWord, wordIndex );
+	m_EndReachedWord			= std::max( m_EndReachedWord, wordIndex + 1 );
+}
+
+bool BitBreadthFirstSearch::Step() {
+	if ( m_FirstWord >= m_EndWord ) {
+		return false;
+	}
+
+	// The frontier before the last one is cleared so that its buffer can take the next level.
+	for ( size_t wordIndex = m_PreviousFirstWord; wordIndex < m_PreviousEndWord; ++wordIndex ) {
+		m_PreviousFrontier[wordIndex]		= 0;
+	}
+
+	// The frontier reaches a row further up and down each level, which is this many words away. Words close to either end of the bitboards have neighbours
+	// that don't exist and read as zero, the words in between are spread without checks.
+	const size_t nrOfWords		= m_Frontier.size();
+	const size_t reach			= m_RowWords + 1;
+	const size_t firstWord		= m_FirstWord > reach ? m_FirstWord - reach : 0;
+	const size_t endWord		= std::min( m_EndWord + reach, nrOfWords );
+	const size_t firstInnerWord	= std::min( std::max( firstWord, reach ), endWord );
+	const size_t endInnerWord	= std::max( std::min( endWord, nrOfWords > reach ? nrOfWords - reach : 0 ), firstInnerWord );
+	m_FirstReachedWord			= std::min( m_FirstReachedWord, firstWord );
+	m_EndReachedWord			= std::max( m_EndReachedWord, endWord );
+	this->SpreadWords<true>( firstWord, firstInnerWord );
+	this->SpreadWords<false>( firstInnerWord, endInnerWord );
+	this->SpreadWords<true>( endInnerWord, endWord );
+
+	// The range of the next frontier, found after spreading so that the loops above stay free of branches.
+	size_t nextFirstWord		= firstWord;
+	while ( nextFirstWord < endWord && m_PreviousFrontier[nextFirstWord] == 0 ) {
+		++nextFirstWord;
+	}
+	size_t nextEndWord			= endWord;
+	while ( nextEndWord > nextFirstWord && m_PreviousFrontier[nextEndWord - 1] == 0 ) {
+		--nextEndWord;
+	}
+
+	// The buffer written to becomes the frontier, the old frontier the previous one.
+	std::swap( m_Frontier, m_PreviousFrontier );
+	m_PreviousFirstWord		= m_FirstWord;
+	m_PreviousEndWord		= m_EndWord;
+	m_FirstWord				= nextFirstWord;
+	m_EndWord				= nextEndWord;
+	++m_Level;
+	return m_FirstWord < m_EndWord;
+}
+
+// Word of the bitboard, or zero if the index is past either end. Indices below zero wrap around and are past the end too.
+template<bool IsChecked>
+static inline uint64_t GetWordAt( const uint64_t* words, size_t nrOfWords, size_t wordIndex ) {
+	return !IsChecked || wordIndex < nrOfWords ? words[wordIndex] : uint64_t( 0 );
+}
+
+// Bits of the tiles in the word that are next to a tile of the frontier. Shifts the frontier one tile in each direction, bits shifted out of a word carry over into the next one.
+template<bool IsChecked>
+static inline uint64_t GetSpreadWord( const uint64_t* frontier, size_t nrOfWords, size_t wordIndex, size_t rowWords, int rowBits ) {
+	const int complementBits	= BITS_PER_WORD - 1 - rowBits;		// Shifting by this and then by one more shifts by 64 - rowBits, which leaves nothing if rowBits is zero.
+	const uint64_t word			= frontier[wordIndex];
+	uint64_t spread				= ( word << 1 ) | ( GetWordAt<IsChecked>( frontier, nrOfWords, wordIndex - 1 ) >> 63 ) | ( word >> 1 ) | ( GetWordAt<IsChecked>( frontier, nrOfWords, wordIndex + 1 ) << 63 );
+	spread						|= ( GetWordAt<IsChecked>( frontier, nrOfWords, wordIndex - rowWords ) << rowBits ) | ( GetWordAt<IsChecked>( frontier, nrOfWords, wordIndex - rowWords - 1 ) >> complementBits >> 1 );
+	spread						|= ( GetWordAt<IsChecked>( frontier, nrOfWords, wordIndex + rowWords ) >> rowBits ) | ( GetWordAt<IsChecked>( frontier, nrOfWords, wordIndex + rowWords + 1 ) << complementBits << 1 );
+	return spread;
+}
+
+template<bool IsChecked>
+void BitBreadthFirstSearch::SpreadWords( size_t firstWord, size_t endWord ) {
+	// Tiles reached before, or blocked, are masked out of the spread frontier. Plain loads and stores in a loop without branches, so that compilers can vectorize it.
+	const uint64_t* frontier	= m_Frontier.data();
+	uint64_t* nextFrontier		= m_PreviousFrontier.data();
+	uint64_t* reached			= m_Reached.data();
+	const uint64_t* blocked		= m_Blocked;
+	const size_t nrOfWords		= m_Frontier.size();
+	const size_t rowWords		= m_RowWords;
+	const int rowBits			= m_RowBits;
+	for ( size_t wordIndex = firstWord; wordIndex < endWord; ++wordIndex ) {
+		const uint64_t newBits		= GetSpreadWord<IsChecked>( frontier, nrOfWords, wordIndex, rowWords, rowBits ) & ~( reached[wordIndex] | blocked[wordIndex] );
+		nextFrontier[wordIndex]		= newBits;
+		reached[wordIndex]			|= newBits;
+	}
+}
+
+bool BitBreadthFirstSearch::StepTailAware( const GameState& gameState, uint32_t arrivalTick ) {
+	if ( m_FirstWord >= m_EndWord ) {
+		return false;
+	}
+	this->Step();
+
+	// Look at the blocked tiles that the frontier spread to, which is now the previous one. Those words were all spread to, so they are within the reached range.
+	// The new frontier may be empty, so its range grows from nothing.
+	const size_t nrOfWords		= m_Frontier.size();
+	const size_t reach			= m_RowWords + 1;
+	const size_t firstWord		= m_PreviousFirstWord > reach ? m_PreviousFirstWord - reach : 0;
+	const size_t endWord		= std::min( m_PreviousEndWord + reach, nrOfWords );
+	if ( m_FirstWord >= m_EndWord ) {
+		m_FirstWord		= nrOfWords;
+		m_EndWord		= 0;
+	}
+	for ( size_t wordIndex = firstWord; wordIndex < endWord; ++wordIndex ) {
+		uint64_t blockedBits		= GetSpreadWord<true>( m_PreviousFrontier.data(), nrOfWords, wordIndex, m_RowWords, m_RowBits ) & gameState.BlockedBits[wordIndex] & ~m_Reached[wordIndex];
+		uint64_t freeBits			= 0;
+		while ( blockedBits != 0 ) {
+			const size_t tile			= wordIndex * BITS_PER_WORD + CountTrailingZeros( blockedBits );
+			const uint64_t tileBit		= blockedBits & ( ~blockedBits + 1 );		// Lowest set bit.
+			blockedBits					&= blockedBits - 1;
+			if ( gameState.GetTileFreeTick( tile ) <= arrivalTick ) {
+				freeBits					|= tileBit;
+			}
+		}
+		if ( freeBits != 0 ) {
+			m_Frontier[wordIndex]		|= freeBits;
+			m_Reached[wordIndex]		|= freeBits;
+			m_FirstWord					= std::min( m_FirstWord, wordIndex );
+			m_EndWord					= std::max( m_EndWord, wordIndex + 1 );
+		}
+	}
+	return m_FirstWord < m_EndWord;
+}
+
+void BitBreadthFirstSearch::FillDistances( std::vector<uint32_t>& outDistances, uint32_t maxLevel ) {
+	outDistances.assign( m_NrOfTiles, UNREACHED );
+	for ( ;; ) {
+		// Only the newly reached tiles are looked at one by one.
+		for ( size_t wordIndex = m_FirstWord; wordIndex < m_EndWord; ++wordIndex ) {
+			for ( uint64_t bits = m_Frontier[wordIndex]; bits != 0; bits &= bits - 1 ) {
+				outDistances[wordIndex * BITS_PER_WORD + CountTrailingZeros( bits )]		= m_Level;
+			}
+		}
+		if ( m_Level >= maxLevel || !this->Step() ) {
+			break;
+		}
+	}
+}
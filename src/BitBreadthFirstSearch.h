@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BitUtility.h"
+
+#define UNREACHED		UINT32_MAX		// Distance of tiles that a search doesn't reach.
+
+class GameState;
+
+// Breadth first search over bitboards laid out like GameState::BlockedBits, from any number of tiles at once. Each level shifts the whole frontier one tile in all four
+// directions a word at a time and masks it with the tiles that are neither blocked nor reached yet, so one operation spreads 64 tiles. Only the words that the frontier
+// can get to within the level are looked at. Callers either step through the levels and look at the tiles of each frontier, or have the distance of every tile written out.
+// Tiles blocked now stay blocked, unless the search is stepped tail aware. The buffers are kept between searches, and only the words a search touched are cleared by the next reset.
+class BitBreadthFirstSearch {
+public:
+								// Starts a search of the board as it is now, with no tiles to start from yet. The state must stay as it is while the search is stepped.
+	void						Reset					( const GameState& gameState );
+								// Adds a tile to the frontier of level zero. Blocked tiles can be started from too, like the heads of snakes. Only valid before the first step.
+	void						AddSource				( size_t tileIndex );
+								// Spreads the frontier one level further. Returns false if no new tile was reached, which ends the search.
+	bool						Step					( );
+								// Same as Step, but blocked tiles next to the frontier are reached too if their snake has moved off them by arrivalTick, the update in which the new
+								// frontier is entered. Tiles that aren't free yet may still be reached by a later step.
+	bool						StepTailAware			( const GameState& gameState, uint32_t arrivalTick );
+								// Steps until the search ends or reaches maxLevel, and writes the level each tile was reached at, or UNREACHED, into outDistances, one entry per tile of the board.
+	void						FillDistances			( std::vector<uint32_t>& outDistances, uint32_t maxLevel = UNREACHED );
+								// Takes a tile out of the frontier, so that the search doesn't spread from it. It still counts as reached.
+	void						RemoveFromFrontier		( size_t tileIndex );
+
+	uint32_t					GetLevel				( ) const;		// Level of the frontier, zero before the first step.
+								// Bitboard of the tiles reached in the last step, and in the step before it. Words outside of [GetFirstWord(), GetEndWord()) of the frontier are zero.
+	const std::vector<uint64_t>&	GetFrontier			( ) const;
+	const std::vector<uint64_t>&	GetPreviousFrontier	( ) const;
+	size_t						GetFirstWord			( ) const;
+	size_t						GetEndWord				( ) const;
+	bool						IsInFrontier			( size_t tileIndex ) const;
+	bool						IsInPreviousFrontier	( size_t tileIndex ) const;
+
+private:
+								// Writes the tiles that the frontier reaches in the words into m_PreviousFrontier, and marks them as reached. Checked reads of the frontier
+								// are needed for words within a row of either end of the bitboards.
+	template<bool IsChecked>
+	void						SpreadWords				( size_t firstWord, size_t endWord );
+
+	const uint64_t*				m_Blocked				= nullptr;				// GameState::BlockedBits of the state the search was reset for, only read while stepping.
+	std::vector<uint64_t>		m_Reached;										// Bitboard of the tiles reached, blocked sources and tiles reached tail aware among them.
+	std::vector<uint64_t>		m_Frontier;
+	std::vector<uint64_t>		m_PreviousFrontier;
+	size_t						m_FirstWord				= 0;
+	size_t						m_EndWord				= 0;
+	size_t						m_PreviousFirstWord		= 0;					// Words of m_PreviousFrontier outside of [m_PreviousFirstWord, m_PreviousEndWord) are zero.
+	size_t						m_PreviousEndWord		= 0;
+	size_t						m_FirstReachedWord		= 0;					// Words of m_Reached outside of [m_FirstReachedWord, m_EndReachedWord) are zero.
+	size_t						m_EndReachedWord		= 0;
+	size_t						m_RowWords				= 0;					// Tiles a whole board row apart are this many words and bits apart in the bitboards.
+	int							m_RowBits				= 0;
+	size_t						m_NrOfTiles				= 0;					// Size of the board the search was reset for.
+	uint32_t					m_Level					= 0;
+};
+
+inline uint32_t BitBreadthFirstSearch::GetLevel() const {
+	return m_Level;
+}
+
+inline const std::vector<uint64_t>& BitBreadthFirstSearch::GetFrontier() const {
+	return m_Frontier;
+}
+
+inline const std::vector<uint64_t>& BitBreadthFirstSearch::GetPreviousFrontier() const {
+	return m_PreviousFrontier;
+}
+
+inline size_t BitBreadthFirstSearch::GetFirstWord() const {
+	return m_FirstWord;
+}
+
+inline size_t BitBreadthFirstSearch::GetEndWord() const {
+	return m_EndWord;
+}
+
+inline bool BitBreadthFirstSearch::IsInFrontier( size_t tileIndex ) const {
+	return ( m_Frontier[tileIndex / BITS_PER_WORD] >> ( tileIndex % BITS_PER_WORD ) ) & 1;
+}
+
+inline bool BitBreadthFirstSearch::IsInPreviousFrontier( size_t tileIndex ) const {
+	return ( m_PreviousFrontier[tileIndex / BITS_PER_WORD] >> ( tileIndex % BITS_PER_WORD ) ) & 1;
+}
+
+inline void BitBreadthFirstSearch::RemoveFromFrontier( size_t tileIndex ) {
+	m_Frontier[tileIndex / BITS_PER_WORD]		&= ~( uint64_t( 1 ) << ( tileIndex % BITS_PER_WORD ) );
+}
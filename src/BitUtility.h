@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define BITS_PER_WORD		64
+
+// Number of bits set in the word.
+inline int PopCount( uint64_t word ) {
+#ifdef _MSC_VER
+	return static_cast<int>( __popcnt64( word ) );
+#else
+	return __builtin_popcountll( word );
+#endif
+}
+
+// Index of the lowest set bit in the word. Undefined behaviour if the word is zero.
+inline int CountTrailingZeros( uint64_t word ) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64( &index, word );
+	return static_cast<int>( index );
+#else
+	return __builtin_ctzll( word );
+#endif
+}
+
+// Index of the highest set bit in the word. Undefined behaviour if the word is zero.
+inline int HighestBitIndex( uint64_t word ) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64( &index, word );
+	return static_cast<int>( index );
+#else
+	return 63 - __builtin_clzll( word );
+#endif
+}
+
+// Mask with the lowest nrOfBits bits set, nrOfBits must be less than 64.
+inline uint64_t LowBitsMask( int nrOfBits ) {
+	return ( uint64_t( 1 ) << nrOfBits ) - 1;
+}
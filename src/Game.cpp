@@ -1,149 +1,309 @@
 #include "Game.h"
 
 #include <glm/geometric.hpp>
-#include "GraphicsEngine2D.h"
-#include "player/Human.h"
+#include "player/AdversarialSearch.h"
+#include "player/AStar.h"
 #include "player/Boids.h"
+#include "player/CooperativeAStar.h"
+#include "player/DStarLite.h"
+#include "player/HierarchicalAStar.h"
+#include "player/JumpPointSearch.h"
+#include "player/MonteCarloTreeSearch.h"
 
 #define GAME_BOARD_WIDTH			70
 #define GAME_BOARD_HEIGHT			50
 #define NR_OF_APPLES				5
 #define NR_OF_SNAKES_PER_TEAM		16
 #define SNAKE_LENGTH				4
-#define SNAKE_GROWTH_PER_APPLE		3
 #define COLOUR_TEAM_1				glm::vec4( 0.0f, 1.0f, 0.0f, 1.0f )
 #define COLOUR_TEAM_2				glm::vec4( 0.0f, 0.0f, 1.0f, 1.0f )
 #define COLOUR_TEAM_3				glm::vec4( 1.0f, 1.0f, 0.0f, 1.0f )
 #define COLOUR_TEAM_4				glm::vec4( 1.0f, 0.0f, 1.0f, 1.0f )
 #define COLOUR_TEAM_5				glm::vec4( 0.0f, 1.0f, 1.0f, 1.0f )
 #define COLOUR_TEAM_6				glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f )
-#define COLOUR_APPLES				glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f )
 
-Game::Game() {
+static_assert( 5 + ( MAX_NR_OF_TEAMS - 1 ) * 10 < GAME_BOARD_HEIGHT, "The spawn row of the last team, see GameState::GameState, must be on the board." );
+
+bool ParseTeamPlayers( const char* letters, std::vector<PlayerType>& outTeamPlayers ) {
+	outTeamPlayers.clear();
+	for ( const char* letter = letters; *letter != '\0'; ++letter ) {
+		if ( *letter == 'B' || *letter == 'b' ) {
+			outTeamPlayers.push_back( PlayerType::Boids );
+		} else if ( *letter == 'A' || *letter == 'a' ) {
+			outTeamPlayers.push_back( PlayerType::AStar );
+		} else if ( *letter == 'J' || *letter == 'j' ) {
+			outTeamPlayers.push_back( PlayerType::JumpPointSearch );
+		} else if ( *letter == 'C' || *letter == 'c' ) {
+			outTeamPlayers.push_back( PlayerType::CooperativeAStar );
+		} else if ( *letter == 'D' || *letter == 'd' ) {
+			outTeamPlayers.push_back( PlayerType::DStarLite );
+		} else if ( *letter == 'H' || *letter == 'h' ) {
+			outTeamPlayers.push_back( PlayerType::HierarchicalAStar );
+		} else if ( *letter == 'M' || *letter == 'm' ) {
+			outTeamPlayers.push_back( PlayerType::MonteCarloTreeSearch );
+		} else if ( *letter == 'S' || *letter == 's' ) {
+			outTeamPlayers.push_back( PlayerType::AdversarialSearch );
+		} else {
+			return false;
+		}
+	}
+	return !outTeamPlayers.empty() && outTeamPlayers.size() <= MAX_NR_OF_TEAMS;
+}
+
+Player* CreateAdversarialSearch( double timeBudgetMs ) {
+	// Room to survive in first, with ways out of the next move weighing most, then the way to the closest apple.
+	auto evaluation		= std::make_unique<WeightedSumEvaluation>();
+	evaluation->Add( 1.0f, std::make_unique<ReachableAreaEvaluation>() );
+	evaluation->Add( 32.0f, std::make_unique<MobilityEvaluation>() );
+	evaluation->Add( 1.0f, std::make_unique<AppleDistanceEvaluation>() );
+	return new AdversarialSearch( std::move( evaluation ), AdversarialSearch::Mode::Paranoid, timeBudgetMs );
+}
+
+Player* CreatePlayer( PlayerType playerType, uint64_t seed, const PlayerSettings& settings ) {
+	switch ( playerType ) {
+		case PlayerType::AStar:		return new AStar();
+		case PlayerType::Boids:		return new Boids( seed );
+		case PlayerType::JumpPointSearch:	return new JumpPointSearch();
+		case PlayerType::CooperativeAStar:	return new CooperativeAStar();
+		case PlayerType::DStarLite:			return new DStarLite();
+		case PlayerType::HierarchicalAStar:	return new HierarchicalAStar();
+		case PlayerType::MonteCarloTreeSearch:	return new MonteCarloTreeSearch( seed, settings.NrOfThreads, settings.TimeBudgetMs );
+		case PlayerType::AdversarialSearch:		return CreateAdversarialSearch( settings.TimeBudgetMs );
+	}
+	return nullptr;
+}
+
+Game::Game( uint64_t seed ) : Game( seed, std::vector<PlayerType>() ) {
+}
+
+Game::Game( uint64_t seed, const std::vector<PlayerType>& teamPlayers, const PlayerSettings& playerSettings ) {
+	static const glm::vec4 teamColours[]		= { COLOUR_TEAM_1, COLOUR_TEAM_2, COLOUR_TEAM_3, COLOUR_TEAM_4, COLOUR_TEAM_5, COLOUR_TEAM_6 };
+
+	std::vector<PlayerType> players		= teamPlayers;
+	if ( players.empty() ) {
+		ParseTeamPlayers( DEFAULT_TEAM_PLAYERS, players );
+	}
+	static_assert( MAX_NR_OF_TEAMS <= sizeof( teamColours ) / sizeof( teamColours[0] ), "Every team needs a colour." );
+	assert( players.size() <= MAX_NR_OF_TEAMS );
+
+	// Every source of randomness gets its own seed derived from the game seed, so that games never share random numbers.
+	Random seedGenerator( seed );
+
 	// Create each team and decide how they are controlled (AI-method or Human).
-	m_TeamDatas.push_back( TeamData( COLOUR_TEAM_1, new Boids(),		NR_OF_SNAKES_PER_TEAM ) );
-	m_TeamDatas.push_back( TeamData( COLOUR_TEAM_2, new Boids(),		NR_OF_SNAKES_PER_TEAM ) );
-	m_TeamDatas.push_back( TeamData( COLOUR_TEAM_3, new Boids(),		NR_OF_SNAKES_PER_TEAM ) );
-	m_TeamDatas.push_back( TeamData( COLOUR_TEAM_4, new Boids(),		NR_OF_SNAKES_PER_TEAM ) );
+	for ( size_t teamIndex = 0; teamIndex < players.size(); ++teamIndex ) {
+		m_TeamDatas.push_back( TeamData( teamColours[teamIndex], CreatePlayer( players[teamIndex], seedGenerator.Next(), playerSettings ) ) );
+		m_TeamMoves.push_back( std::vector<Move>( NR_OF_SNAKES_PER_TEAM ) );
+		m_IsTerritoryUsed		= m_IsTerritoryUsed || m_TeamDatas.back().Player->UsesTerritory();
+	}
 
 	// Create the initial game state.
-	m_MainState		= new GameState( glm::uvec2( GAME_BOARD_WIDTH, GAME_BOARD_HEIGHT ), m_TeamDatas.size(), NR_OF_SNAKES_PER_TEAM, SNAKE_LENGTH, NR_OF_APPLES );
+	m_MainState		= new GameState( glm::uvec2( GAME_BOARD_WIDTH, GAME_BOARD_HEIGHT ), m_TeamDatas.size(), NR_OF_SNAKES_PER_TEAM, SNAKE_LENGTH, NR_OF_APPLES, seedGenerator.Next() );
 }
 
 Game::~Game() {
 	if ( m_MainState		) { delete m_MainState;		m_MainState		= nullptr; }
+	for ( auto& teamData : m_TeamDatas ) {
+		if ( teamData.Player ) { delete teamData.Player;	teamData.Player		= nullptr; }
+	}
 }
 
 void Game::Update() {
+	// Find the way to the apples and the territory of each snake once for all the players.
+	m_MainState->AppleFlow.Update( *m_MainState );
+	if ( m_IsTerritoryUsed ) {
+		m_MainState->Territory.Update( *m_MainState );
+	}
+
 	// Get moves from all the players.
 	for ( size_t teamIndex = 0; teamIndex < m_TeamDatas.size(); ++teamIndex ) {
 		if ( m_MainState->Teams[teamIndex].Snakes.empty() ) {		// Check if team is dead.
 			continue;		// Skip dead team.
 		}
-		m_TeamDatas[teamIndex].Player->MakeMoves( *m_MainState, teamIndex, m_TeamDatas[teamIndex].Moves );
+		m_TeamDatas[teamIndex].Player->MakeMoves( *m_MainState, teamIndex, m_TeamMoves[teamIndex] );
+	}
+
+	m_ApplesEaten.assign( m_TeamDatas.size(), 0 );
+	ApplyMoves( *m_MainState, m_TeamMoves, m_ApplesEaten.data() );
+
+	for ( size_t teamIndex = 0; teamIndex < m_TeamDatas.size(); ++teamIndex ) {
+		m_TeamDatas[teamIndex].ApplesEaten		+= m_ApplesEaten[teamIndex];
+		if ( !m_MainState->Teams[teamIndex].Snakes.empty() ) {
+			++m_TeamDatas[teamIndex].TicksSurvived;
+		}
+	}
+}
+
+void Game::ApplyMoves( GameState& state, std::vector<std::vector<Move>>& teamMoves, size_t* outApplesEaten, MoveUndo* outUndo ) {
+	// Start tracking the tiles changed by this update. Players see them on the next tick.
+	if ( outUndo ) {
+		outUndo->Entries.clear();
+		outUndo->EatenApples.clear();
+		outUndo->RemovedSnakes.clear();
+		outUndo->ChangedTiles.swap( state.ChangedTiles );
 	}
+	state.ChangedTiles.clear();
 
 	// Remove the tails of the snakes.
-	for ( auto& team : m_MainState->Teams ) {
-		for ( auto& snake : team.Snakes ) {
-			this->RemoveTail( snake );
+	for ( size_t teamIndex = 0; teamIndex < state.Teams.size(); ++teamIndex ) {
+		Team& team		= state.Teams[teamIndex];
+		for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+			RemoveTail( state, team.Snakes[snakeIndex], static_cast<uint32_t>( teamIndex ), static_cast<uint32_t>( snakeIndex ), outUndo );
 		}
 	}
 
 	// Remove dead snakes that have had all their segments removed.
-	for ( size_t snakeIndex = 0; snakeIndex < m_DeadSnakes.size(); ++snakeIndex ) {
-		if ( m_DeadSnakes[snakeIndex].Segments.empty() ) {
-			m_DeadSnakes.erase( m_DeadSnakes.begin() + snakeIndex );
+	for ( size_t snakeIndex = 0; snakeIndex < state.DeadSnakes.size(); ++snakeIndex ) {
+		if ( state.DeadSnakes[snakeIndex].Segments.empty() ) {
+			if ( outUndo ) {
+				outUndo->Entries.push_back( { MoveUndoStep::DeadSnakeRemoved, Tile::Open, UNDO_DEAD_SNAKES, static_cast<uint32_t>( snakeIndex ), NO_OPEN_TILE_SLOT, 0, glm::ivec2( 0 ) } );
+				outUndo->RemovedSnakes.push_back( std::move( state.DeadSnakes[snakeIndex] ) );
+			}
+			state.DeadSnakes.erase( state.DeadSnakes.begin() + snakeIndex );
 			--snakeIndex;
 		}
 	}
 
 	// Remove the tails of the dead snakes, so that they stop blocking the game board eventually.
-	for ( auto& deadSnake : m_DeadSnakes ) {
-		this->RemoveTail( deadSnake );
+	for ( size_t snakeIndex = 0; snakeIndex < state.DeadSnakes.size(); ++snakeIndex ) {
+		RemoveTail( state, state.DeadSnakes[snakeIndex], UNDO_DEAD_SNAKES, static_cast<uint32_t>( snakeIndex ), outUndo );
 	}
 
 	// Insert new heads onto the snakes.
-	for ( size_t teamIndex = 0; teamIndex < m_MainState->Teams.size(); ++teamIndex ) {
-		Team& team		= m_MainState->Teams[teamIndex];
+	for ( size_t teamIndex = 0; teamIndex < state.Teams.size(); ++teamIndex ) {
+		Team& team		= state.Teams[teamIndex];
 		for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
 			Snake& snake					= team.Snakes[snakeIndex];
-			const Move move					= m_TeamDatas[teamIndex].Moves[snakeIndex];
-			const glm::ivec2 movingTo		= *snake.Segments.begin() + ConvertMoveToIVec2( move );
+			const Move move					= teamMoves[teamIndex][snakeIndex];
+			const glm::ivec2 movingTo		= snake.Segments.front() + ConvertMoveToIVec2( move );
+			MoveUndoEntry undoEntry			= { MoveUndoStep::SnakeDied, Tile::Open, static_cast<uint32_t>( teamIndex ), static_cast<uint32_t>( snakeIndex ), NO_OPEN_TILE_SLOT, 0, glm::ivec2( 0 ) };
 
 			// Kill snake if it tries to move onto an unwalkable tile.
-			if ( !m_MainState->IsTileWalkable( movingTo ) ) {
-				m_DeadSnakes.push_back( snake );
+			if ( !state.IsTileWalkable( movingTo ) ) {
+				if ( outUndo ) {
+					outUndo->Entries.push_back( undoEntry );
+				}
+				state.DeadSnakes.push_back( std::move( snake ) );
 				team.Snakes.erase( team.Snakes.begin() + snakeIndex );
-				m_TeamDatas[teamIndex].Moves.erase( m_TeamDatas[teamIndex].Moves.begin() + snakeIndex );
+				teamMoves[teamIndex].erase( teamMoves[teamIndex].begin() + snakeIndex );
 				--snakeIndex;
 				continue;
 			}
 
 			// Check if an apple gets eaten.
-			if (  m_MainState->Board[movingTo.y][movingTo.x] == Tile::Apple ) {
-				snake.SegmentsToSpawn		+= SNAKE_GROWTH_PER_APPLE;
-
-				// Find apple that was eaten and respawn it.
-				for ( auto& apple : m_MainState->Apples ) {
-					if ( apple == movingTo ) {
-						m_MainState->SpawnApple( apple );
-					}
+			if ( state.GetTile( movingTo ) == Tile::Apple ) {
+				state.AddSnakeGrowth( snake, SNAKE_GROWTH_PER_APPLE );
+				if ( outApplesEaten ) {
+					++outApplesEaten[teamIndex];
+				}
+
+				const EatenApple eatenApple		= state.EatApple( movingTo );		// Respawns the apple somewhere else.
+				if ( outUndo ) {
+					undoEntry.Step		= MoveUndoStep::AppleEaten;
+					outUndo->Entries.push_back( undoEntry );
+					outUndo->EatenApples.push_back( eatenApple );
 				}
 			}
 
-			// Insert the new head segment.
-			snake.Segments.insert( snake.Segments.begin(), movingTo );
-			m_MainState->Board[movingTo.y][movingTo.x]		= Tile::Blocked;		// Mark the heads new position as blocked.
+			if ( outUndo ) {
+				const size_t tileIndex		= state.GetTileIndex( movingTo );
+				undoEntry.Step				= MoveUndoStep::HeadAdded;
+				undoEntry.PreviousTile		= state.Board[tileIndex];
+				undoEntry.OpenTileSlot		= state.OpenTileSlots[tileIndex];
+				undoEntry.Serial			= state.TileSerials[tileIndex];
+				outUndo->Entries.push_back( undoEntry );
+			}
+			state.AddSnakeHead( snake, movingTo );		// Insert the new head segment and mark its position as blocked.
 		}
 	}
-}
 
-void Game::Draw( GraphicsEngine2D& graphicsEngine ) {
-	// Calculate screen location of the playable area.
-	const glm::vec2 windowSize					= glm::vec2( graphicsEngine.GetWindowsSize() );
-	const glm::vec2 scale						= glm::vec2( glm::min( windowSize.x / m_MainState->Size.x, windowSize.y / m_MainState->Size.y ) );
-	const glm::vec2 playableAreaSize			= scale * glm::vec2( m_MainState->Size );
-	const glm::vec2 playableAreaPosition		= 0.5f * ( glm::vec2( graphicsEngine.GetWindowsSize() ) - playableAreaSize );
+	++state.Tick;
+}
 
-	// Draw the game board.
-	graphicsEngine.DrawRectangle( playableAreaPosition, playableAreaSize, glm::vec4( glm::vec3( 0.1f ), 1.0f ) );
+void Game::UndoMoves( GameState& state, MoveUndo& undo ) {
+	--state.Tick;
 
-	// Draw tiles that are blocked.
-	for ( size_t y = 0; y < m_MainState->Size.y; ++y ) {
-		for ( size_t x = 0; x < m_MainState->Size.x; ++x ) {
-			if ( m_MainState->Board[y][x] == Tile::Blocked ) {
-				graphicsEngine.DrawRectangle( playableAreaPosition + scale * glm::vec2( x, y ), scale );
-			}
+	// Every change is undone in reverse, so the indices recorded for each snake are valid again by the time its changes are undone.
+	auto recordedSnake		= [&state]( const MoveUndoEntry& entry ) -> Snake& {
+		return entry.TeamIndex == UNDO_DEAD_SNAKES ? state.DeadSnakes[entry.SnakeIndex] : state.Teams[entry.TeamIndex].Snakes[entry.SnakeIndex];
+	};
+	for ( auto entry = undo.Entries.rbegin(); entry != undo.Entries.rend(); ++entry ) {
+		switch ( entry->Step ) {
+			case MoveUndoStep::SpawnUsed: {
+				Snake& snake		= recordedSnake( *entry );
+				state.SetSegmentsToSpawn( snake, snake.SegmentsToSpawn + 1 );
+			} break;
+			case MoveUndoStep::TailRemoved: {
+				state.RestoreSnakeTail( recordedSnake( *entry ), entry->Tail );
+			} break;
+			case MoveUndoStep::DeadSnakeRemoved: {
+				state.DeadSnakes.insert( state.DeadSnakes.begin() + entry->SnakeIndex, std::move( undo.RemovedSnakes.back() ) );
+				undo.RemovedSnakes.pop_back();
+			} break;
+			case MoveUndoStep::SnakeDied: {
+				std::vector<Snake>& snakes		= state.Teams[entry->TeamIndex].Snakes;
+				snakes.insert( snakes.begin() + entry->SnakeIndex, std::move( state.DeadSnakes.back() ) );
+				state.DeadSnakes.pop_back();
+			} break;
+			case MoveUndoStep::AppleEaten: {
+				state.UneatApple( undo.EatenApples.back() );
+				undo.EatenApples.pop_back();
+				state.RemoveSnakeGrowth( recordedSnake( *entry ), SNAKE_GROWTH_PER_APPLE );
+			} break;
+			case MoveUndoStep::HeadAdded: {
+				state.RemoveSnakeHead( recordedSnake( *entry ), entry->PreviousTile, entry->OpenTileSlot, entry->Serial );
+			} break;
 		}
 	}
+	undo.Entries.clear();
 
-	// Draw snakes.
-	for ( size_t teamIndex = 0; teamIndex < m_MainState->Teams.size(); ++teamIndex ) {
-		Team& team							= m_MainState->Teams[teamIndex];
-		const glm::vec4 teamHeadColour		= glm::vec4(  glm::clamp( 0.5f + glm::vec3( m_TeamDatas[teamIndex].Colour ), 0.0f, 1.0f ), 1.0f );		// Make head colour brighter.
-		const glm::vec4 teamTailColour		= glm::vec4(  glm::vec3( 0.5f * m_TeamDatas[teamIndex].Colour ), 1.0f );								// Make tail colour darker.
+	state.ChangedTiles.swap( undo.ChangedTiles );
+}
 
-		for ( auto snake : team.Snakes ) {
-			for ( size_t segmentIndex = 0; segmentIndex < snake.Segments.size(); ++segmentIndex ) {
-				const float normalizedSegmentPos		= static_cast<float>(segmentIndex) / snake.Segments.size();										// From 0 (head) to 1 (tail).
-				const glm::vec4 segmentColour			= ( 1.0f - normalizedSegmentPos ) * teamHeadColour + normalizedSegmentPos * teamTailColour;		// Change colour smothly from head to tail.
-				const glm::vec2 segmentPosition			= playableAreaPosition + scale * glm::vec2( snake.Segments[segmentIndex] );
-				graphicsEngine.DrawRectangle( segmentPosition, scale, segmentColour );
-			}
+size_t Game::GetNrOfTeamsAlive() const {
+	size_t nrOfTeamsAlive		= 0;
+	for ( const auto& team : m_MainState->Teams ) {
+		if ( !team.Snakes.empty() ) {
+			++nrOfTeamsAlive;
 		}
 	}
+	return nrOfTeamsAlive;
+}
+
+size_t Game::GetTeamLength( size_t teamIndex ) const {
+	size_t teamLength		= 0;
+	for ( const auto& snake : m_MainState->Teams[teamIndex].Snakes ) {
+		teamLength		+= snake.Segments.size() + snake.SegmentsToSpawn;
+	}
+	return teamLength;
+}
 
-	// Draw Apples.
-	for ( const auto& apple : m_MainState->Apples ) {
-		const glm::vec2 applePosition		= playableAreaPosition + scale * ( glm::vec2( apple ) );
-		graphicsEngine.DrawCircle( applePosition, 0.5f * scale.x, COLOUR_APPLES );
+size_t Game::GetTick() const {
+	return m_MainState->Tick;
+}
+
+void Game::CopySnapshot( GameSnapshot& outSnapshot ) const {
+	m_MainState->CopyTo( outSnapshot.State );
+	outSnapshot.Tick			= m_MainState->Tick;
+	outSnapshot.TeamColours.resize( m_TeamDatas.size() );
+	for ( size_t teamIndex = 0; teamIndex < m_TeamDatas.size(); ++teamIndex ) {
+		outSnapshot.TeamColours[teamIndex]		= m_TeamDatas[teamIndex].Colour;
 	}
 }
 
-void Game::RemoveTail( Snake& snake ) {
+const GameState& Game::GetState() const {
+	return *m_MainState;
+}
+
+const std::vector<TeamData>& Game::GetTeamDatas() const {
+	return m_TeamDatas;
+}
+
+void Game::RemoveTail( GameState& state, Snake& snake, uint32_t teamIndex, uint32_t snakeIndex, MoveUndo* outUndo ) {
 	if ( snake.SegmentsToSpawn > 0 ) {		// Don't remove tail of snake if there are segments left to spawn (e.g after eating).
-		--snake.SegmentsToSpawn;
+		state.SetSegmentsToSpawn( snake, snake.SegmentsToSpawn - 1 );
+		if ( outUndo ) {
+			outUndo->Entries.push_back( { MoveUndoStep::SpawnUsed, Tile::Open, teamIndex, snakeIndex, NO_OPEN_TILE_SLOT, 0, glm::ivec2( 0 ) } );
+		}
 		return;
 	}
 
@@ -151,7 +311,8 @@ void Game::RemoveTail( Snake& snake ) {
 		return;
 	}
 
-	const glm::ivec2 tailPosition							= *(snake.Segments.end() - 1);
-	m_MainState->Board[tailPosition.y][tailPosition.x]		= Tile::Open;						// Mark the tails position as free.
-	snake.Segments.pop_back();																	// Remove the tail of the snake.
+	if ( outUndo ) {
+		outUndo->Entries.push_back( { MoveUndoStep::TailRemoved, Tile::Open, teamIndex, snakeIndex, NO_OPEN_TILE_SLOT, 0, snake.Segments.back() } );
+	}
+	state.RemoveSnakeTail( snake );		// Remove the tail of the snake and mark its position as free.
 }
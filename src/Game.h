@@ -4,32 +4,111 @@
 #include <glm/geometric.hpp>
 #include "GameState.h"
 
-class		GraphicsEngine2D;
+#define DEFAULT_GAME_SEED			1		// Games are fully determined by their seed.
+#define DEFAULT_TEAM_PLAYERS		"BBBB"	// One letter per team, see ParseTeamPlayers.
+#define MAX_NR_OF_TEAMS				5		// Teams spawn in rows 10 tiles apart, and no more fit on the board.
+#define UNDO_DEAD_SNAKES			UINT32_MAX		// Team index of undo entries about snakes in GameState::DeadSnakes.
+
 class		Player;
 enum class	Move;
 
+// AI-methods that can control a team.
+enum class PlayerType {
+	Boids,
+	AStar,
+	JumpPointSearch,
+	CooperativeAStar,
+	DStarLite,
+	HierarchicalAStar,
+	MonteCarloTreeSearch,
+	AdversarialSearch
+};
+
+// Converts a string with one letter per team into player types, B for Boids, A for A*, J for Jump Point Search, C for cooperative A*, D for D* Lite, H for hierarchical A*, M for Monte Carlo tree search and S for adversarial search. Returns false if any letter is unknown, or if there are more than MAX_NR_OF_TEAMS.
+bool ParseTeamPlayers( const char* letters, std::vector<PlayerType>& outTeamPlayers );
+
+// How the players of a game are set up, the same for every team.
+struct PlayerSettings {
+	size_t					NrOfThreads		= 0;		// Threads each player may search with, zero uses one per hardware thread. Batches that play a game per core use one.
+	double					TimeBudgetMs	= 0.0;		// Time per tick that players who search may take, each team on its own. Zero searches a fixed amount instead, so that games stay determined by their seed.
+};
+
 struct TeamData {
-	TeamData( const glm::vec4& colour, Player* player, size_t nrOfSnakes ) {
+	TeamData( const glm::vec4& colour, ::Player* player ) {
 		this->Colour		= glm::clamp( colour, 0.0f, 1.0f );
 		this->Player		= player;
-		Moves.resize( nrOfSnakes );
 	}
 	glm::vec4				Colour;
-	Player*					Player;
-	std::vector<Move>		Moves;
+	::Player*				Player;
+	size_t					ApplesEaten		= 0;
+	size_t					TicksSurvived	= 0;		// Number of ticks the team had snakes alive at the end of.
+};
+
+// The kinds of change Game::ApplyMoves makes to a state.
+enum class MoveUndoStep : uint8_t {
+	SpawnUsed,				// A segment still to spawn was used up instead of removing the tail.
+	TailRemoved,
+	DeadSnakeRemoved,		// A dead snake without segments left was removed from GameState::DeadSnakes.
+	SnakeDied,				// A snake moved from its team to the end of GameState::DeadSnakes.
+	AppleEaten,				// The snake grew and the apple respawned.
+	HeadAdded
+};
+
+struct MoveUndoEntry {
+	MoveUndoStep			Step;
+	Tile					PreviousTile;		// HeadAdded: the tile the head moved onto, open or an apple.
+	uint32_t				TeamIndex;			// Team of the snake, or UNDO_DEAD_SNAKES for GameState::DeadSnakes.
+	uint32_t				SnakeIndex;			// Index of the snake in its team or in GameState::DeadSnakes when the change was made.
+	uint32_t				OpenTileSlot;		// HeadAdded: slot of the tile in GameState::OpenTiles before the head moved onto it.
+	uint32_t				Serial;				// HeadAdded: serial of the tile before the head moved onto it.
+	glm::ivec2				Tail;				// TailRemoved: where the tail was.
+};
+
+// Everything one Game::ApplyMoves changed, so that Game::UndoMoves can restore the exact state from before it.
+// Searches keep one record per depth and reuse it, so that applying and undoing moves stops allocating once the buffers have grown.
+struct MoveUndo {
+	std::vector<MoveUndoEntry>	Entries;			// In the order the changes were made.
+	std::vector<EatenApple>		EatenApples;		// One per AppleEaten entry, in the same order. Includes the random state.
+	std::vector<Snake>			RemovedSnakes;		// One per DeadSnakeRemoved entry, in the same order.
+	std::vector<uint32_t>		ChangedTiles;		// GameState::ChangedTiles from before the update, swapped out rather than copied.
+};
+
+// Copy of everything needed to draw a game, so that it can be drawn while the game keeps updating.
+struct GameSnapshot {
+	GameState				State;
+	std::vector<glm::vec4>	TeamColours;
+	size_t					Tick			= 0;
 };
 
 class Game {
 public:
-								Game					( );
+	explicit					Game					( uint64_t seed = DEFAULT_GAME_SEED );
+								Game					( uint64_t seed, const std::vector<PlayerType>& teamPlayers, const PlayerSettings& playerSettings = PlayerSettings() );
 								~Game					( );
 	void						Update					( );
-	void						Draw					( GraphicsEngine2D& graphicsEngine );
+	size_t						GetNrOfTeamsAlive		( ) const;
+	size_t						GetTeamLength			( size_t teamIndex ) const;		// Total length of the teams living snakes, including segments still to spawn.
+	size_t						GetTick					( ) const;
+	void						CopySnapshot			( GameSnapshot& outSnapshot ) const;
+
+								// Runs one update of the game rules on the state, the same one Update runs once it has the moves of the players. Usable on any state, so that players can simulate the game.
+								// teamMoves has a move for every living snake of each team, the moves of snakes that die are erased along with the snakes.
+								// The number of apples each team eats is added to outApplesEaten, one entry per team, unless it is null.
+								// If outUndo isn't null, everything the update changes is recorded in it, replacing what it held before.
+	static void					ApplyMoves				( GameState& state, std::vector<std::vector<Move>>& teamMoves, size_t* outApplesEaten, MoveUndo* outUndo = nullptr );
+								// Restores the state to exactly what it was before the ApplyMoves that recorded the undo, which must be the last update applied to it that hasn't been undone yet.
+								// Neither the moves erased along with dead snakes nor the apples eaten are given back. The record is used up.
+	static void					UndoMoves				( GameState& state, MoveUndo& undo );
+
+	const GameState&			GetState				( ) const;
+	const std::vector<TeamData>&	GetTeamDatas		( ) const;
 
 private:
-	void						RemoveTail				( Snake& snake );
+	static void					RemoveTail				( GameState& state, Snake& snake, uint32_t teamIndex, uint32_t snakeIndex, MoveUndo* outUndo );
 
 	GameState*					m_MainState				= nullptr;
 	std::vector<TeamData>		m_TeamDatas;
-	std::vector<Snake>			m_DeadSnakes;
+	std::vector<std::vector<Move>>	m_TeamMoves;		// The moves the players chose for each snake, one list per team.
+	std::vector<size_t>			m_ApplesEaten;			// Apples eaten by each team in the current update.
+	bool						m_IsTerritoryUsed		= false;		// Set if any player reads GameState::Territory.
 };
@@ -0,0 +1,54 @@
+#include "GameRenderer.h"
+
+#include <glm/geometric.hpp>
+#include "Game.h"
+#include "GraphicsEngine2D.h"
+
+#define COLOUR_APPLES				glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f )
+
+void GameRenderer::Draw( const GameSnapshot& snapshot, GraphicsEngine2D& graphicsEngine ) const {
+	const GameState& gameState					= snapshot.State;
+
+	// Calculate screen location of the playable area.
+	const glm::vec2 windowSize					= glm::vec2( graphicsEngine.GetWindowsSize() );
+	const glm::vec2 scale						= glm::vec2( glm::min( windowSize.x / gameState.Size.x, windowSize.y / gameState.Size.y ) );
+	const glm::vec2 playableAreaSize			= scale * glm::vec2( gameState.Size );
+	const glm::vec2 playableAreaPosition		= 0.5f * ( glm::vec2( graphicsEngine.GetWindowsSize() ) - playableAreaSize );
+
+	// Everything is added to a single batch, so the whole frame is submitted in one draw call.
+	graphicsEngine.BeginBatch();
+
+	// Draw the game board.
+	graphicsEngine.AddQuad( playableAreaPosition, playableAreaSize, glm::vec4( glm::vec3( 0.1f ), 1.0f ) );
+
+	// Draw the remains of dead snakes. Together with the living snakes these are all the blocked tiles, so the board itself never has to be scanned.
+	for ( const auto& deadSnake : gameState.DeadSnakes ) {
+		for ( size_t segmentIndex = 0; segmentIndex < deadSnake.Segments.size(); ++segmentIndex ) {
+			graphicsEngine.AddQuad( playableAreaPosition + scale * glm::vec2( deadSnake.Segments[segmentIndex] ), scale );
+		}
+	}
+
+	// Draw snakes.
+	for ( size_t teamIndex = 0; teamIndex < gameState.Teams.size(); ++teamIndex ) {
+		const Team& team					= gameState.Teams[teamIndex];
+		const glm::vec4 teamHeadColour		= glm::vec4(  glm::clamp( 0.5f + glm::vec3( snapshot.TeamColours[teamIndex] ), 0.0f, 1.0f ), 1.0f );		// Make head colour brighter.
+		const glm::vec4 teamTailColour		= glm::vec4(  glm::vec3( 0.5f * snapshot.TeamColours[teamIndex] ), 1.0f );								// Make tail colour darker.
+
+		for ( const auto& snake : team.Snakes ) {
+			for ( size_t segmentIndex = 0; segmentIndex < snake.Segments.size(); ++segmentIndex ) {
+				const float normalizedSegmentPos		= static_cast<float>(segmentIndex) / snake.Segments.size();										// From 0 (head) to 1 (tail).
+				const glm::vec4 segmentColour			= ( 1.0f - normalizedSegmentPos ) * teamHeadColour + normalizedSegmentPos * teamTailColour;		// Change colour smothly from head to tail.
+				const glm::vec2 segmentPosition			= playableAreaPosition + scale * glm::vec2( snake.Segments[segmentIndex] );
+				graphicsEngine.AddQuad( segmentPosition, scale, segmentColour );
+			}
+		}
+	}
+
+	// Draw Apples.
+	for ( const auto& apple : gameState.Apples ) {
+		const glm::vec2 applePosition		= playableAreaPosition + scale * ( glm::vec2( apple ) );
+		graphicsEngine.AddCircle( applePosition, 0.5f * scale.x, COLOUR_APPLES );
+	}
+
+	graphicsEngine.Flush();
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+class		GraphicsEngine2D;
+struct		GameSnapshot;
+
+// Draws a game using the graphics engine. Kept apart from Game so that the simulation itself never depends on SFML.
+class GameRenderer {
+public:
+	void						Draw					( const GameSnapshot& snapshot, GraphicsEngine2D& graphicsEngine ) const;
+};
@@ -1,10 +1,14 @@
 #include "GameState.h"
 
-#include <glm/geometric.hpp>
+#include <cfloat>
 
 #define SNAKE_LENGTH_MINIMUM		2		// Minimum snake length is set to the lowest number that doesn't cause the game to crash.
 
-GameState::GameState( const glm::uvec2& size, size_t nrOfTeams, size_t snakesPerTeam, size_t snakeLength, size_t nrOfApples ) {
+static uint64_t GetHeadKey( const Snake& snake, size_t headTileIndex ) {
+	return ZobristKey( ZobristFeature::Head, snake.Id, headTileIndex );
+}
+
+GameState::GameState( const glm::uvec2& size, size_t nrOfTeams, size_t snakesPerTeam, size_t snakeLength, size_t nrOfApples, uint64_t seed ) {
 	// Make sure that the input doesn't cause problems.
 	assert( 0 < size.x								);
 	assert( 0 < size.y								);
@@ -12,14 +16,22 @@ GameState::GameState( const glm::uvec2& size, size_t nrOfTeams, size_t snakesPer
 	assert( 0 < snakesPerTeam						);
 	assert( SNAKE_LENGTH_MINIMUM <= snakeLength		);
 
-	this->Size		= size;
+	this->Size			= size;
+	this->AppleRandom	= Random( seed );
 
-	// Initialize the game board.
-	this->Board.resize( this->Size.y );		// Create all rows
-	for ( auto& row : this->Board ) {
-		row.resize( this->Size.x );			// Set each rows to the specified size.
-		for ( auto& tile : row ) {
-			tile		= Tile::Open;		// Mark each tile as open.
+	// Initialize the game board, with a border of blocked tiles acting as walls.
+	this->BoardStride		= this->Size.x + 2 * BOARD_PADDING;
+	this->Board.assign( this->BoardStride * ( this->Size.y + 2 * BOARD_PADDING ), Tile::Blocked );
+	this->BlockedBits.assign( this->Board.size() / BITS_PER_WORD + 2, ~uint64_t( 0 ) );		// Rounded up, plus a spare word so that reads of several bits never go past the end.
+	this->OpenTileSlots.assign( this->Board.size(), NO_OPEN_TILE_SLOT );
+	this->TileSnakeIds.assign( this->Board.size(), NO_SNAKE );
+	this->TileSerials.assign( this->Board.size(), 0 );
+	this->FreeTickOffsets.assign( nrOfTeams * snakesPerTeam, 0 );
+	this->OpenTiles.clear();
+	this->OpenTiles.reserve( this->Size.x * this->Size.y );
+	for ( int y = 0; y < static_cast<int>(this->Size.y); ++y ) {
+		for ( int x = 0; x < static_cast<int>(this->Size.x); ++x ) {
+			this->SetTile( glm::ivec2( x, y ), Tile::Open );		// Mark each tile inside the walls as open.
 		}
 	}
 
@@ -32,52 +44,255 @@ GameState::GameState( const glm::uvec2& size, size_t nrOfTeams, size_t snakesPer
 		team.Snakes.resize( snakesPerTeam );		// Create all snakes in each team.
 		for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
 			Snake& snake										= team.Snakes[snakeIndex];
-			snake.SegmentsToSpawn								= snakeLength - 1;									// Only the snakes head is on the board at the start, rest of the body gets spawned later.
+			snake.Id											= static_cast<uint32_t>( teamIndex * snakesPerTeam + snakeIndex );
 			const glm::ivec2 spawnPosition						= glm::ivec2(	5 + snakeIndex * 3,					// Arbitrary spawn position.					// TODO: Revamp spawn positions.
 																				5 + teamIndex * 10 );					
-			this->Board[spawnPosition.y][spawnPosition.x]		= Tile::Blocked;									// Block the snakes position in the board.
-			snake.Segments.push_back( spawnPosition );
+			this->AddSnakeHead( snake, spawnPosition );																	// Block the snakes position in the board.
+			this->FreeTickOffsets[snake.Id]						= 1;												// The first tail removal happens in the first update.
+			this->AddSnakeGrowth( snake, snakeLength - 1 );															// Only the snakes head is on the board at the start, rest of the body gets spawned later.
 		}
 	}
 
 	// Initialize apples.
-	this->Apples.resize( nrOfApples );		// Create all apples.
-	for ( auto& apple : this->Apples ) {
-		this->SpawnApple( apple );
+	this->Apples.reserve( nrOfApples );		// Create all apples, or as many as there is room for.
+	glm::ivec2 apple;
+	while ( this->Apples.size() < nrOfApples && this->SpawnApple( apple ) ) {
+		this->Apples.push_back( apple );
 	}
+	this->AppleCells.Reset( this->Size, this->Apples );
+	this->ChangedTiles.clear();		// Nothing has changed since the start.
+	this->Hash		= this->ComputeHash();		// The walls were never set through SetTile, so the hash kept so far is missing them.
 }
 
-void GameState::SpawnApple( glm::ivec2& apple ) {
-	// Randomize a spawn location for the apple until an open position is found.
-	do {
-		apple.x		= rand() % this->Size.x;
-		apple.y		= rand() % this->Size.y;
-	} while ( this->Board[apple.y][apple.x] != Tile::Open );
-
-	this->Board[apple.y][apple.x]		= Tile::Apple;		// Block the tile so that other apples can't spawn on it.
+bool GameState::SpawnApple( glm::ivec2& apple ) {
+	uint32_t openTileSlot;
+	return this->SpawnApple( apple, openTileSlot );
 }
 
-bool GameState::IsTileWalkable( const glm::ivec2& tile ) const {
-	if ( tile.x < 0 || tile.y < 0 || static_cast<size_t>(tile.x) >= this->Size.x || static_cast<size_t>(tile.y) >= this->Size.y ) {		// Check collision against walls.
+bool GameState::SpawnApple( glm::ivec2& apple, uint32_t& outOpenTileSlot ) {
+	if ( this->OpenTiles.empty() ) {		// Board is full.
 		return false;
 	}
-	return this->Board[tile.y][tile.x] != Tile::Blocked;		// Check if destination tile is blocked.
+
+	// Pick a random open tile and convert its board index back to a position.
+	outOpenTileSlot				= this->AppleRandom.NextBelow( static_cast<uint32_t>( this->OpenTiles.size() ) );
+	const size_t tileIndex		= this->OpenTiles[outOpenTileSlot];
+	apple.x						= static_cast<int>( tileIndex % this->BoardStride ) - BOARD_PADDING;
+	apple.y						= static_cast<int>( tileIndex / this->BoardStride ) - BOARD_PADDING;
+
+	this->SetTile( apple, Tile::Apple );		// Block the tile so that other apples can't spawn on it.
+	return true;
 }
 
-glm::ivec2 GameState::FindClosestApple( const glm::vec2& position ) const {
-	glm::ivec2 closestApple			= position;		// Arbitrary initial value, will be overwritten if any apples exist.
-	float closestDistanceSqrd		= FLT_MAX;		// Initial value chosen so that the first apple will overwrite it.
-
-	for ( const auto& apple : this->Apples ) {
-		// Calculate distance (squared) to the apple.
-		const glm::vec2 vectorToApple		= glm::vec2( apple ) - position;
-		const float distanceToAppleSqrd		= glm::dot( vectorToApple, vectorToApple );
-
-		// Save information about the apple if it is closer than the previously closest apple.
-		if ( distanceToAppleSqrd < closestDistanceSqrd ) {
-			closestDistanceSqrd		= distanceToAppleSqrd;
-			closestApple			= apple;
+EatenApple GameState::EatApple( const glm::ivec2& tile ) {
+	EatenApple eatenApple;
+	eatenApple.AppleIndex		= this->AppleCells.FindAppleAt( this->Apples, tile );
+	eatenApple.Position			= tile;
+	eatenApple.RandomState		= this->AppleRandom.GetState();
+	if ( eatenApple.AppleIndex == NO_APPLE ) {
+		return eatenApple;
+	}
+
+	const uint32_t appleIndex		= eatenApple.AppleIndex;
+	glm::ivec2& apple				= this->Apples[appleIndex];
+	this->AppleCells.Remove( appleIndex, apple );
+	if ( this->SpawnApple( apple, eatenApple.OpenTileSlot ) ) {
+		this->AppleCells.Insert( appleIndex, apple );
+		return eatenApple;
+	}
+
+	// The board is full, so the apple is removed. The last apple takes its place to keep the indices of the other apples unchanged.
+	const uint32_t lastAppleIndex		= static_cast<uint32_t>( this->Apples.size() - 1 );
+	if ( appleIndex != lastAppleIndex ) {
+		this->AppleCells.Remove( lastAppleIndex, this->Apples[lastAppleIndex] );
+		this->Apples[appleIndex]		= this->Apples[lastAppleIndex];
+		this->AppleCells.Insert( appleIndex, this->Apples[appleIndex] );
+	}
+	this->Apples.pop_back();
+	return eatenApple;
+}
+
+void GameState::AddSnakeHead( Snake& snake, const glm::ivec2& tile ) {
+	const size_t tileIndex				= this->GetTileIndex( tile );
+	if ( !snake.Segments.empty() ) {
+		this->Hash						^= GetHeadKey( snake, this->GetTileIndex( snake.Segments.front() ) );
+	}
+	this->Hash							^= GetHeadKey( snake, tileIndex );
+
+	snake.Segments.reserve( snake.Segments.size() + 1 + snake.SegmentsToSpawn );		// Room is made for all pending growth at once, so the body is reallocated at most once per meal.
+	snake.Segments.push_front( tile );
+	this->SetTile( tile, Tile::Blocked );
+
+	this->TileSnakeIds[tileIndex]		= snake.Id;
+	this->TileSerials[tileIndex]		= snake.NrOfHeadsAdded++;
+}
+
+void GameState::RemoveSnakeTail( Snake& snake ) {
+	const glm::ivec2 tail								= snake.Segments.back();
+	this->TileSnakeIds[this->GetTileIndex( tail )]		= NO_SNAKE;
+	this->SetTile( tail, Tile::Open );
+	snake.Segments.pop_back();
+	if ( snake.Segments.empty() ) {		// The tail was the head too.
+		this->Hash										^= GetHeadKey( snake, this->GetTileIndex( tail ) );
+	}
+}
+
+void GameState::AddSnakeGrowth( Snake& snake, size_t nrOfSegments ) {
+	this->SetSegmentsToSpawn( snake, snake.SegmentsToSpawn + nrOfSegments );
+	this->FreeTickOffsets[snake.Id]				+= static_cast<uint32_t>( nrOfSegments );		// Every segment stays that many ticks longer.
+}
+
+void GameState::SetSegmentsToSpawn( Snake& snake, size_t nrOfSegments ) {
+	this->Hash							^= GetSpawnKey( snake );
+	snake.SegmentsToSpawn				= nrOfSegments;
+	this->Hash							^= GetSpawnKey( snake );
+}
+
+void GameState::UneatApple( const EatenApple& eatenApple ) {
+	if ( eatenApple.AppleIndex == NO_APPLE ) {
+		return;
+	}
+	const uint32_t appleIndex		= eatenApple.AppleIndex;
+	this->AppleRandom.SetState( eatenApple.RandomState );
+
+	// Take the apple back from the tile it respawned on.
+	if ( eatenApple.OpenTileSlot != NO_OPEN_TILE_SLOT ) {
+		glm::ivec2& apple		= this->Apples[appleIndex];
+		this->AppleCells.Remove( appleIndex, apple );
+		this->RestoreTile( this->GetTileIndex( apple ), Tile::Open, eatenApple.OpenTileSlot );
+		apple					= eatenApple.Position;
+		this->AppleCells.Insert( appleIndex, apple );
+		return;
+	}
+
+	// The apple was removed, so the apple that took its place goes back to the end.
+	const uint32_t lastAppleIndex		= static_cast<uint32_t>( this->Apples.size() );
+	if ( appleIndex != lastAppleIndex ) {
+		const glm::ivec2 movedApple		= this->Apples[appleIndex];
+		this->AppleCells.Remove( appleIndex, movedApple );
+		this->Apples.push_back( movedApple );
+		this->AppleCells.Insert( lastAppleIndex, movedApple );
+		this->Apples[appleIndex]		= eatenApple.Position;
+	} else {
+		this->Apples.push_back( eatenApple.Position );
+	}
+	this->AppleCells.Insert( appleIndex, eatenApple.Position );
+}
+
+void GameState::RemoveSnakeHead( Snake& snake, Tile previousTile, uint32_t previousOpenTileSlot, uint32_t previousSerial ) {
+	const size_t tileIndex				= this->GetTileIndex( snake.Segments.front() );
+	this->TileSnakeIds[tileIndex]		= NO_SNAKE;		// Heads only move onto open tiles and apples, which never have a snake on them.
+	this->TileSerials[tileIndex]		= previousSerial;
+	--snake.NrOfHeadsAdded;
+	snake.Segments.pop_front();
+	this->RestoreTile( tileIndex, previousTile, previousOpenTileSlot );
+
+	this->Hash							^= GetHeadKey( snake, tileIndex );
+	if ( !snake.Segments.empty() ) {
+		this->Hash						^= GetHeadKey( snake, this->GetTileIndex( snake.Segments.front() ) );
+	}
+}
+
+void GameState::RestoreSnakeTail( Snake& snake, const glm::ivec2& tail ) {
+	const size_t tileIndex				= this->GetTileIndex( tail );
+	this->TileSnakeIds[tileIndex]		= snake.Id;		// The serial of the tail is still on the tile, since removing the tail leaves it.
+	if ( snake.Segments.empty() ) {
+		this->Hash						^= GetHeadKey( snake, tileIndex );
+	}
+	snake.Segments.push_back( tail );
+	this->RestoreTile( tileIndex, Tile::Blocked, NO_OPEN_TILE_SLOT );
+}
+
+void GameState::RemoveSnakeGrowth( Snake& snake, size_t nrOfSegments ) {
+	assert( nrOfSegments <= snake.SegmentsToSpawn );
+	this->SetSegmentsToSpawn( snake, snake.SegmentsToSpawn - nrOfSegments );
+	this->FreeTickOffsets[snake.Id]				-= static_cast<uint32_t>( nrOfSegments );
+}
+
+void GameState::RestoreTile( size_t tileIndex, Tile value, uint32_t openTileSlot ) {
+	const uint64_t tileBit				= uint64_t( 1 ) << ( tileIndex % BITS_PER_WORD );
+	uint64_t& blockedWord				= this->BlockedBits[tileIndex / BITS_PER_WORD];
+	blockedWord							= value == Tile::Blocked ? ( blockedWord | tileBit ) : ( blockedWord & ~tileBit );
+
+	if ( this->Board[tileIndex] == Tile::Open && value != Tile::Open ) {
+		// AddOpenTile appended the tile, and everything appended after it has been undone already.
+		assert( this->OpenTileSlots[tileIndex] == this->OpenTiles.size() - 1 );
+		this->OpenTiles.pop_back();
+		this->OpenTileSlots[tileIndex]		= NO_OPEN_TILE_SLOT;
+	} else if ( this->Board[tileIndex] != Tile::Open && value == Tile::Open ) {
+		// RemoveOpenTile moved the last open tile into the slot, so it goes back to the end. The slot is past the end if the tile was the last one itself.
+		assert( openTileSlot <= this->OpenTiles.size() );
+		if ( openTileSlot < this->OpenTiles.size() ) {
+			const uint32_t movedTileIndex				= this->OpenTiles[openTileSlot];
+			this->OpenTileSlots[movedTileIndex]			= static_cast<uint32_t>( this->OpenTiles.size() );
+			this->OpenTiles.push_back( movedTileIndex );
+			this->OpenTiles[openTileSlot]				= static_cast<uint32_t>( tileIndex );
+		} else {
+			this->OpenTiles.push_back( static_cast<uint32_t>( tileIndex ) );
 		}
+		this->OpenTileSlots[tileIndex]		= openTileSlot;
+	}
+	this->Hash							^= GetTileKey( tileIndex, this->Board[tileIndex] ) ^ GetTileKey( tileIndex, value );
+	this->Board[tileIndex]				= value;
+}
+
+void GameState::CopyTo( GameState& outState ) const {
+	if ( &outState == this ) {
+		return;
 	}
+
+	// Assigning vectors only reallocates when the destination is too small, so copying into the same state over and over is allocation free.
+	outState		= *this;
+}
+
+uint64_t GameState::ComputeHash() const {
+	uint64_t hash		= 0;
+	for ( size_t tileIndex = 0; tileIndex < this->Board.size(); ++tileIndex ) {
+		hash			^= GetTileKey( tileIndex, this->Board[tileIndex] );
+	}
+	auto addSnake		= [this, &hash]( const Snake& snake ) {
+		if ( !snake.Segments.empty() ) {
+			hash		^= GetHeadKey( snake, this->GetTileIndex( snake.Segments.front() ) );
+		}
+		hash			^= GetSpawnKey( snake );
+	};
+	for ( const auto& team : this->Teams ) {
+		for ( const auto& snake : team.Snakes ) {
+			addSnake( snake );
+		}
+	}
+	for ( const auto& deadSnake : this->DeadSnakes ) {
+		addSnake( deadSnake );
+	}
+	return hash;
+}
+
+glm::ivec2 GameState::FindClosestApple( const glm::vec2& position ) const {
+	glm::ivec2 closestApple		= position;		// Returned if no apples exist.
+	this->FindClosestApple( position, FLT_MAX, closestApple );
 	return closestApple;
 }
+
+bool GameState::FindClosestApple( const glm::vec2& position, float maxDistance, glm::ivec2& outApple ) const {
+	const uint32_t appleIndex		= this->AppleCells.FindClosest( this->Apples, position, maxDistance );
+	if ( appleIndex == NO_APPLE ) {
+		return false;
+	}
+	outApple		= this->Apples[appleIndex];
+	return true;
+}
+
+void GameState::AddOpenTile( size_t tileIndex ) {
+	this->OpenTileSlots[tileIndex]		= static_cast<uint32_t>( this->OpenTiles.size() );
+	this->OpenTiles.push_back( static_cast<uint32_t>( tileIndex ) );
+}
+
+void GameState::RemoveOpenTile( size_t tileIndex ) {
+	// Move the last open tile into the slot of the removed one, so that the array stays dense without shifting.
+	const uint32_t slot						= this->OpenTileSlots[tileIndex];
+	const uint32_t lastTileIndex			= this->OpenTiles.back();
+	this->OpenTiles[slot]					= lastTileIndex;
+	this->OpenTileSlots[lastTileIndex]		= slot;
+	this->OpenTiles.pop_back();
+	this->OpenTileSlots[tileIndex]			= NO_OPEN_TILE_SLOT;
+}
\ No newline at end of file
@@ -1,17 +1,42 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <vector>
+#include "AppleFlowField.h"
+#include "AppleGrid.h"
+#include "BitUtility.h"
+#include "Random.h"
+#include "SnakeBody.h"
+#include "TerritoryMap.h"
+#include "ZobristHash.h"
 
-enum class Tile {
+#define NO_OPEN_TILE_SLOT	UINT32_MAX		// Slot of tiles that are not in GameState::OpenTiles.
+#define NO_SNAKE			UINT32_MAX		// Snake id of tiles without a snake segment.
+#define NEVER_FREE			UINT32_MAX		// Free tick of walls.
+#define BOARD_PADDING		2		// Width of the border of permanently blocked tiles around the board. Lets tiles up to this distance outside of the board be looked up without bounds checks.
+#define SNAKE_GROWTH_PER_APPLE	3		// Number of segments a snake grows by for each apple it eats.
+
+enum class Tile : uint8_t {
 	Open,
 	Blocked,
 	Apple
 };
 
 struct Snake {
-	std::vector<glm::ivec2>		Segments;								// Positions of the snakes body. Starts with head and ends in the tail.
+	SnakeBody					Segments;								// Positions of the snakes body. Starts with head and ends in the tail.
 	size_t						SegmentsToSpawn				= 0;		// Number of segments that the snake should increase it's size by.
+	uint32_t					Id							= NO_SNAKE;	// Unique within the game, stays the same after the snake dies.
+	uint32_t					NrOfHeadsAdded				= 0;		// Also the serial number the next head segment gets.
+};
+
+// What GameState::EatApple did, so that GameState::UneatApple can undo it.
+struct EatenApple {
+	uint32_t					AppleIndex					= NO_APPLE;				// NO_APPLE if there was no apple on the tile.
+	glm::ivec2					Position					= glm::ivec2( 0 );		// The tile the apple was eaten on.
+	uint32_t					OpenTileSlot				= NO_OPEN_TILE_SLOT;	// Slot in GameState::OpenTiles of the tile the apple respawned on, or NO_OPEN_TILE_SLOT if the board was full and the apple was removed.
+	uint64_t					RandomState					= 0;					// GameState::AppleRandom before the apple respawned.
 };
 
 struct Team {
@@ -20,18 +45,160 @@ struct Team {
 
 class GameState {
 public:
-										GameState			( const glm::uvec2& size, size_t nrOfTeams, size_t snakesPerTeam, size_t snakeLength, size_t nrOfApples );
+										GameState			( ) = default;		// Empty state, only useful as a destination for CopyTo.
+										GameState			( const glm::uvec2& size, size_t nrOfTeams, size_t snakesPerTeam, size_t snakeLength, size_t nrOfApples, uint64_t seed );
 	
-										// The vec2 is totally an apple, trust me.
-	void								SpawnApple			( glm::ivec2& apple );
+										// The vec2 is totally an apple, trust me. Picks a uniformly random open tile, returns false (leaving the apple untouched) if there are none.
+	bool								SpawnApple			( glm::ivec2& apple );
+										// Respawns the apple on the tile, or removes it if the board is full.
+	EatenApple							EatApple			( const glm::ivec2& tile );
+
+										// Moving snakes. These keep the board and the free tick of the snakes tiles up to date.
+	void								AddSnakeHead		( Snake& snake, const glm::ivec2& tile );
+	void								RemoveSnakeTail		( Snake& snake );
+	void								AddSnakeGrowth		( Snake& snake, size_t nrOfSegments );
+										// Changes the number of segments still to spawn without touching free ticks, like using one up instead of removing the tail does.
+	void								SetSegmentsToSpawn	( Snake& snake, size_t nrOfSegments );
 
+										// Undoing the changes above, which must be undone in the reverse order they were made in so that OpenTiles ends up in its old order.
+										// None of these add to ChangedTiles. See Game::UndoMoves.
+	void								UneatApple			( const EatenApple& eatenApple );
+										// The previous values are the tile, its OpenTiles slot and its serial from before the head moved onto it.
+	void								RemoveSnakeHead		( Snake& snake, Tile previousTile, uint32_t previousOpenTileSlot, uint32_t previousSerial );
+	void								RestoreSnakeTail	( Snake& snake, const glm::ivec2& tail );
+	void								RemoveSnakeGrowth	( Snake& snake, size_t nrOfSegments );
+										// Sets a tile back to the value it had before SetTile changed it. openTileSlot is its old slot in OpenTiles if the value is open.
+	void								RestoreTile			( size_t tileIndex, Tile value, uint32_t openTileSlot );
+
+										// Copies the state into another one, reusing the memory already allocated by it. Cheaper than constructing a new copy when done repeatedly.
+	void								CopyTo				( GameState& outState ) const;
+
+										// Tiles must be on the board or within BOARD_PADDING tiles of it.
+	size_t								GetTileIndex		( const glm::ivec2& tile ) const;
+	Tile								GetTile				( const glm::ivec2& tile ) const;
+	void								SetTile				( const glm::ivec2& tile, Tile value );
 	bool								IsTileWalkable		( const glm::ivec2& tile ) const;
+	bool								IsTileWalkable		( size_t tileIndex ) const;
+
+										// Hash of the state from scratch, equal to Hash unless something changed the state without going through the methods above.
+	uint64_t							ComputeHash			( ) const;
 
-										// Undefined behaviour if no apples exist.
+										// Tick of the update in which the tile stops being blocked, assuming the snake on it keeps moving. Walls are NEVER_FREE and unblocked tiles are free already (0).
+										// A head moving onto the tile during that update (or later) doesn't collide with it, since tails are removed before heads move.
+	uint32_t							GetTileFreeTick		( size_t tileIndex ) const;
+										// True if the tile will be free for a head arriving in the given update, the next update is Tick + 1.
+	bool								IsTileWalkableAt	( size_t tileIndex, size_t arrivalTick ) const;
+
+										// Reads from the blocked bitboard, bit i of the result is set if tile tileIndex + i is blocked. nrOfBits must be less than 64.
+	bool								IsTileBlockedBit	( size_t tileIndex ) const;
+	uint64_t							GetBlockedBits		( size_t tileIndex, int nrOfBits ) const;
+
+										// Returns the position itself if no apples exist.
 	glm::ivec2							FindClosestApple	( const glm::vec2& position ) const;
+										// Returns false if there is no apple within maxDistance of the position.
+	bool								FindClosestApple	( const glm::vec2& position, float maxDistance, glm::ivec2& outApple ) const;
 										
-	glm::uvec2							Size;				// Size of the game board.
-	std::vector<std::vector<Tile>>		Board;				// Shows the state of each tile on the game board.
+	glm::uvec2							Size				= glm::uvec2( 0 );		// Size of the game board.
+	size_t								BoardStride			= 0;					// Distance between two vertically adjacent tiles in Board, neighbours of a tile index are at -BoardStride, +BoardStride, -1 and +1.
+	std::vector<Tile>					Board;				// Shows the state of each tile on the game board. Stored row by row, including the blocked border.
+	std::vector<uint64_t>				BlockedBits;		// One bit per entry in Board, set if the tile is blocked. Kept in sync by SetTile.
+	std::vector<uint32_t>				OpenTiles;			// Board index of every open tile, in no particular order. Kept in sync by SetTile.
+	std::vector<uint32_t>				OpenTileSlots;		// One entry per entry in Board, the position of the tile in OpenTiles or NO_OPEN_TILE_SLOT.
 	std::vector<Team>					Teams;				// Teams of snakes.
+	std::vector<Snake>					DeadSnakes;			// Snakes that have died but still have segments on the board. Their tails keep being removed, so that they stop blocking the board eventually.
 	std::vector<glm::ivec2>				Apples;				// Positions of the apples spawned.
+	AppleGrid							AppleCells;			// Spatial index of Apples. Kept in sync by EatApple.
+	AppleFlowField						AppleFlow;			// Way to the closest apple from every tile. Updated by Game once per tick before the players move, states changed in other ways must update it themselves.
+	TerritoryMap						Territory;			// Which snake reaches each tile first. Updated by Game once per tick before the players move if any player uses it, see Player::UsesTerritory.
+	Random								AppleRandom;		// Decides where apples spawn. Part of the state so that games don't share random numbers.
+	uint32_t							Tick				= 0;	// Number of updates done.
+	uint64_t							Hash				= 0;	// Zobrist hash of the board (snake segments, walls and apples), the head of every snake with segments and the segments each snake has still to spawn.
+																	// Kept up to date in O(1) by the methods that change those. The tick, the order of the apples and which snake is on a tile are not part of it.
+	std::vector<uint32_t>				ChangedTiles;		// Board index of every tile that SetTile has changed since Game last cleared the list, which it does right before updating the board. Can hold a tile more than once.
+
+	// Free tick bookkeeping. Every segment of a snake is removed one tick after the one before it, except that the removals pause for the segments still to spawn.
+	// So a segments free tick is its serial number plus an offset that is the same for the whole snake and only changes when the snake grows.
+	std::vector<uint32_t>				TileSnakeIds;		// One entry per entry in Board, id of the snake with a segment on the tile or NO_SNAKE.
+	std::vector<uint32_t>				TileSerials;		// One entry per entry in Board, serial number of the segment on the tile.
+	std::vector<uint32_t>				FreeTickOffsets;	// Per snake id, added to a segments serial to get its free tick.
+
+private:
+	static uint64_t						GetTileKey			( size_t tileIndex, Tile value );		// Zero for open tiles, so that only the tiles that aren't open make up the hash.
+	static uint64_t						GetSpawnKey			( const Snake& snake );					// Zero if the snake has nothing to spawn.
+
+	bool								SpawnApple			( glm::ivec2& apple, uint32_t& outOpenTileSlot );
+	void								AddOpenTile			( size_t tileIndex );
+	void								RemoveOpenTile		( size_t tileIndex );
 };
+
+inline size_t GameState::GetTileIndex( const glm::ivec2& tile ) const {
+	assert( -BOARD_PADDING <= tile.x && tile.x < static_cast<int>(this->Size.x) + BOARD_PADDING );
+	assert( -BOARD_PADDING <= tile.y && tile.y < static_cast<int>(this->Size.y) + BOARD_PADDING );
+	return ( tile.y + BOARD_PADDING ) * this->BoardStride + ( tile.x + BOARD_PADDING );
+}
+
+inline Tile GameState::GetTile( const glm::ivec2& tile ) const {
+	return this->Board[GetTileIndex( tile )];
+}
+
+inline void GameState::SetTile( const glm::ivec2& tile, Tile value ) {
+	const size_t tileIndex				= GetTileIndex( tile );
+	const uint64_t tileBit				= uint64_t( 1 ) << ( tileIndex % BITS_PER_WORD );
+	uint64_t& blockedWord				= this->BlockedBits[tileIndex / BITS_PER_WORD];
+	blockedWord							= value == Tile::Blocked ? ( blockedWord | tileBit ) : ( blockedWord & ~tileBit );
+
+	if ( this->Board[tileIndex] != value ) {
+		this->ChangedTiles.push_back( static_cast<uint32_t>( tileIndex ) );
+		this->Hash						^= GetTileKey( tileIndex, this->Board[tileIndex] ) ^ GetTileKey( tileIndex, value );
+	}
+	if ( this->Board[tileIndex] != Tile::Open && value == Tile::Open ) {
+		this->AddOpenTile( tileIndex );
+	} else if ( this->Board[tileIndex] == Tile::Open && value != Tile::Open ) {
+		this->RemoveOpenTile( tileIndex );
+	}
+	this->Board[tileIndex]				= value;
+}
+
+inline uint64_t GameState::GetTileKey( size_t tileIndex, Tile value ) {
+	return value == Tile::Open ? 0 : ZobristKey( ZobristFeature::Tile, tileIndex, static_cast<uint64_t>( value ) );
+}
+
+inline uint64_t GameState::GetSpawnKey( const Snake& snake ) {
+	return snake.SegmentsToSpawn == 0 ? 0 : ZobristKey( ZobristFeature::SegmentsToSpawn, snake.Id, snake.SegmentsToSpawn );
+}
+
+inline bool GameState::IsTileWalkable( const glm::ivec2& tile ) const {
+	return this->Board[GetTileIndex( tile )] != Tile::Blocked;		// Walls are part of the board as blocked tiles, so no separate collision check is needed.
+}
+
+inline bool GameState::IsTileWalkable( size_t tileIndex ) const {
+	return this->Board[tileIndex] != Tile::Blocked;
+}
+
+
+inline bool GameState::IsTileBlockedBit( size_t tileIndex ) const {
+	return ( this->BlockedBits[tileIndex / BITS_PER_WORD] >> ( tileIndex % BITS_PER_WORD ) ) & 1;
+}
+
+inline uint64_t GameState::GetBlockedBits( size_t tileIndex, int nrOfBits ) const {
+	assert( 0 < nrOfBits && nrOfBits < BITS_PER_WORD );
+	const size_t wordIndex		= tileIndex / BITS_PER_WORD;
+	const int bitOffset			= static_cast<int>( tileIndex % BITS_PER_WORD );
+	uint64_t bits				= this->BlockedBits[wordIndex] >> bitOffset;
+	if ( bitOffset + nrOfBits > BITS_PER_WORD ) {		// The bits are split over two words. BlockedBits has a spare word at the end so that the next word always exists.
+		bits					|= this->BlockedBits[wordIndex + 1] << ( BITS_PER_WORD - bitOffset );
+	}
+	return bits & LowBitsMask( nrOfBits );
+}
+
+inline uint32_t GameState::GetTileFreeTick( size_t tileIndex ) const {
+	if ( this->Board[tileIndex] != Tile::Blocked ) {
+		return 0;
+	}
+	const uint32_t snakeId		= this->TileSnakeIds[tileIndex];
+	return snakeId == NO_SNAKE ? NEVER_FREE : this->TileSerials[tileIndex] + this->FreeTickOffsets[snakeId];
+}
+
+inline bool GameState::IsTileWalkableAt( size_t tileIndex, size_t arrivalTick ) const {
+	return this->GetTileFreeTick( tileIndex ) <= arrivalTick;
+}
\ No newline at end of file
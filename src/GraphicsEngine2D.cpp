@@ -1,18 +1,31 @@
 #include "GraphicsEngine2D.h"
 
+#include <cmath>
 #include <SFML/Graphics.hpp>
 
+#define BATCH_CIRCLE_SEGMENTS		16		// Number of triangles each batched circle is made of.
+#define FRAME_RATE_LIMIT			60		// Swap waits to keep rendering from using more time than needed.
+
 GraphicsEngine2D::GraphicsEngine2D( const glm::uvec2& windowSize, const std::string& windowTitle, bool fullscreen ) {
 	sf::Uint32 windowStyle		= fullscreen ? sf::Style::Fullscreen : sf::Style::Default;
 	m_Window					= new sf::RenderWindow( sf::VideoMode( windowSize.x, windowSize.y ), windowTitle, windowStyle );
+	m_Window->setFramerateLimit( FRAME_RATE_LIMIT );
 	m_Circle					= new sf::CircleShape();
 	m_Rectangle					= new sf::RectangleShape();
+	m_Batch						= new sf::VertexArray( sf::Triangles );
+
+	m_CircleOffsets.resize( BATCH_CIRCLE_SEGMENTS + 1 );		// First point is repeated at the end to close the circle.
+	for ( size_t i = 0; i < m_CircleOffsets.size(); ++i ) {
+		const float angle		= 2.0f * 3.14159265f * static_cast<float>(i % BATCH_CIRCLE_SEGMENTS) / BATCH_CIRCLE_SEGMENTS;
+		m_CircleOffsets[i]		= glm::vec2( std::cos( angle ), std::sin( angle ) );
+	}
 }
 
 GraphicsEngine2D::~GraphicsEngine2D() {
 	if ( m_Window			) { delete m_Window;		m_Window		= nullptr; }
 	if ( m_Circle			) { delete m_Circle;		m_Circle		= nullptr; }
 	if ( m_Rectangle		) { delete m_Rectangle;		m_Rectangle		= nullptr; }
+	if ( m_Batch			) { delete m_Batch;			m_Batch			= nullptr; }
 }
 
 void GraphicsEngine2D::Clear() {
@@ -46,6 +59,45 @@ void GraphicsEngine2D::DrawRectangle( const glm::vec2& position, const glm::vec2
 	m_Window->draw( *m_Rectangle );
 }
 
+void GraphicsEngine2D::BeginBatch() {
+	m_Batch->clear();		// Keeps the allocated memory, so batches of similar size don't reallocate every frame.
+}
+
+void GraphicsEngine2D::AddCircle( const glm::vec2& position, float radius, const glm::vec4& colour ) {
+	// Build the circle as a fan of triangles around its center. Position is the top left corner of the bounding box, same as DrawCircle.
+	const sf::Color colourSf		= ConvertVec4ToColor( colour );
+	const glm::vec2 center			= position + glm::vec2( radius );
+	for ( size_t i = 0; i < BATCH_CIRCLE_SEGMENTS; ++i ) {
+		const glm::vec2 point1		= center + radius * m_CircleOffsets[i];
+		const glm::vec2 point2		= center + radius * m_CircleOffsets[i + 1];
+		m_Batch->append( sf::Vertex( sf::Vector2f( center.x, center.y ),	colourSf ) );
+		m_Batch->append( sf::Vertex( sf::Vector2f( point1.x, point1.y ),	colourSf ) );
+		m_Batch->append( sf::Vertex( sf::Vector2f( point2.x, point2.y ),	colourSf ) );
+	}
+}
+
+void GraphicsEngine2D::AddQuad( const glm::vec2& position, const glm::vec2& size, const glm::vec4& colour ) {
+	// Two triangles per quad, so that quads and circles can share the same batch.
+	const sf::Color colourSf		= ConvertVec4ToColor( colour );
+	const sf::Vector2f topLeft		= sf::Vector2f( position.x,				position.y );
+	const sf::Vector2f topRight		= sf::Vector2f( position.x + size.x,	position.y );
+	const sf::Vector2f bottomLeft	= sf::Vector2f( position.x,				position.y + size.y );
+	const sf::Vector2f bottomRight	= sf::Vector2f( position.x + size.x,	position.y + size.y );
+	m_Batch->append( sf::Vertex( topLeft,		colourSf ) );
+	m_Batch->append( sf::Vertex( topRight,		colourSf ) );
+	m_Batch->append( sf::Vertex( bottomLeft,	colourSf ) );
+	m_Batch->append( sf::Vertex( bottomLeft,	colourSf ) );
+	m_Batch->append( sf::Vertex( topRight,		colourSf ) );
+	m_Batch->append( sf::Vertex( bottomRight,	colourSf ) );
+}
+
+void GraphicsEngine2D::Flush() {
+	if ( m_Batch->getVertexCount() > 0 ) {
+		m_Window->draw( *m_Batch );
+	}
+	m_Batch->clear();
+}
+
 bool GraphicsEngine2D::IsWindowOpen() const {
 	return m_Window->isOpen();
 }
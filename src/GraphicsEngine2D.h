@@ -3,6 +3,7 @@
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <string>
+#include <vector>
 
 // Pre-declerations of sfml classes to avoid exposing sfml headers to users of this class.
 namespace sf {
@@ -10,6 +11,7 @@ namespace sf {
 	class Color;
 	class CircleShape;
 	class RectangleShape;
+	class VertexArray;
 };
 
 class GraphicsEngine2D {
@@ -22,6 +24,13 @@ public:
 	void						HandleEvents				( );
 	void						DrawCircle					( const glm::vec2& position, float radius,			const glm::vec4& colour = glm::vec4( 1.0f ) );
 	void						DrawRectangle				( const glm::vec2& position, const glm::vec2& size,	const glm::vec4& colour = glm::vec4( 1.0f ) );
+
+								// Batched drawing, shapes added between BeginBatch and Flush are submitted together in a single draw call and drawn in the order they were added.
+	void						BeginBatch					( );
+	void						AddCircle					( const glm::vec2& position, float radius,			const glm::vec4& colour = glm::vec4( 1.0f ) );
+	void						AddQuad						( const glm::vec2& position, const glm::vec2& size,	const glm::vec4& colour = glm::vec4( 1.0f ) );
+	void						Flush						( );
+
 	bool						IsWindowOpen				( ) const;
 	glm::uvec2					GetWindowsSize				( ) const;
 
@@ -32,4 +41,6 @@ private:
 	sf::RenderWindow*			m_Window					= nullptr;
 	sf::CircleShape*			m_Circle					= nullptr;
 	sf::RectangleShape*			m_Rectangle					= nullptr;
+	sf::VertexArray*			m_Batch						= nullptr;
+	std::vector<glm::vec2>		m_CircleOffsets;						// Points on the unit circle used when adding circles to the batch.
 };
\ No newline at end of file
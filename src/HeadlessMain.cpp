@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "Game.h"
+#include "player/Player.h"
+
+#define DEFAULT_MAX_TICKS		100000		// Upper limit on ticks so that a stalemate doesn't run forever.
+
+// Runs a single game without any window or frame delay, stepping the simulation as fast as possible.
+// Usage: SnakeHeadless [maxTicks] [teamPlayers] [timeBudgetMs], team players is one letter per team, B for Boids, A for A*, J for Jump Point Search, C for cooperative A*, D for D* Lite, H for hierarchical A*, M for Monte Carlo tree search and S for adversarial search.
+// The time budget is per tick and team for the players that search, M and S. Zero, the default, has them search a fixed amount, so that the game only depends on its seed.
+int main( int argc, char** argv ) {
+	const size_t maxTicks		= argc > 1 ? static_cast<size_t>( std::strtoull( argv[1], nullptr, 10 ) ) : DEFAULT_MAX_TICKS;
+	std::vector<PlayerType> teamPlayers;
+	if ( !ParseTeamPlayers( argc > 2 ? argv[2] : DEFAULT_TEAM_PLAYERS, teamPlayers ) ) {
+		std::fprintf( stderr, "Invalid team players \"%s\", use one letter per team for up to %d teams: B (Boids), A (A*), J (Jump Point Search), C (cooperative A*), D (D* Lite), H (hierarchical A*), M (Monte Carlo tree search) or S (adversarial search).\n", argv[2], MAX_NR_OF_TEAMS );
+		return 1;
+	}
+
+	PlayerSettings playerSettings;
+	playerSettings.TimeBudgetMs	= argc > 3 ? std::strtod( argv[3], nullptr ) : 0.0;
+	Game game( DEFAULT_GAME_SEED, teamPlayers, playerSettings );
+
+	const auto startTime		= std::chrono::steady_clock::now();
+	size_t tick					= 0;
+	double slowestTickSeconds	= 0.0;		// Shows whether the players kept to their time budget.
+	while ( tick < maxTicks && game.GetNrOfTeamsAlive() > 1 ) {		// Game is over when a single team (or none) is left.
+		const auto tickStartTime	= std::chrono::steady_clock::now();
+		game.Update();
+		const std::chrono::duration<double> tickElapsed		= std::chrono::steady_clock::now() - tickStartTime;
+		slowestTickSeconds			= std::max( slowestTickSeconds, tickElapsed.count() );
+		++tick;
+	}
+	const std::chrono::duration<double> elapsed		= std::chrono::steady_clock::now() - startTime;
+
+	std::printf( "Ticks:        %zu\n",		tick );
+	std::printf( "Teams alive:  %zu\n",		game.GetNrOfTeamsAlive() );
+	std::printf( "Time:         %.3f s\n",	elapsed.count() );
+	std::printf( "Ticks/sec:    %.1f\n",	elapsed.count() > 0.0 ? tick / elapsed.count() : 0.0 );
+	std::printf( "Slowest tick: %.3f ms\n",	slowestTickSeconds * 1000.0 );
+
+	// Players that search game trees report how fast they went.
+	for ( size_t teamIndex = 0; teamIndex < game.GetTeamDatas().size(); ++teamIndex ) {
+		const Player* player		= game.GetTeamDatas()[teamIndex].Player;
+		if ( player->GetNrOfNodes() > 0 ) {
+			std::printf( "Team %zu nodes: %zu in %.3f s, %.0f nodes/sec\n", teamIndex + 1, player->GetNrOfNodes(), player->GetSearchSeconds(),
+				player->GetSearchSeconds() > 0.0 ? player->GetNrOfNodes() / player->GetSearchSeconds() : 0.0 );
+		}
+	}
+
+	return 0;	// Exit success.
+}
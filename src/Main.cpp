@@ -1,21 +1,27 @@
-#include <chrono>
+#include <cstdlib>
 #include <SFML/Window/Keyboard.hpp>
-#include <thread>
-#include "Game.h"
+#include "GameRenderer.h"
 #include "GraphicsEngine2D.h"
+#include "SimulationThread.h"
 
 #define WINDOW_RESOLUTION_WIDTH			720
 #define WINDOW_RESOLUTION_HEIGHT		360
 #define WINDOW_FULLSCREEN				false
 #define WINDOW_TITLE					"Snake pathfinding"
+#define DEFAULT_TICKS_PER_SECOND		12.0		// Slow enough that it is possible to see what is going on.
 #define KEY_GAME_EXIT					sf::Keyboard::Key::Escape
 #define KEY_GAME_RESET					sf::Keyboard::Key::R
 
-int main() {
+// Usage: SnakePathfinding [ticksPerSecond], a tick rate of 0 runs the simulation uncapped.
+int main( int argc, char** argv ) {
+	const double ticksPerSecond		= argc > 1 ? std::strtod( argv[1], nullptr ) : DEFAULT_TICKS_PER_SECOND;
+
 	GraphicsEngine2D graphicsEngine( glm::uvec2( WINDOW_RESOLUTION_WIDTH, WINDOW_RESOLUTION_HEIGHT ), WINDOW_TITLE, WINDOW_FULLSCREEN );
-	Game game;
+	GameRenderer gameRenderer;
+	GameSnapshot snapshot;
+	SimulationThread simulation( ticksPerSecond );		// The game is updated on its own thread, this thread only handles the window.
 
-	// Main game loop
+	// Main render loop
 	while ( true ) {
 		graphicsEngine.Clear();
 
@@ -26,17 +32,16 @@ int main() {
 
 		// Reset the game if requested by the user.
 		if ( sf::Keyboard::isKeyPressed( KEY_GAME_RESET ) ) {
-			new (&game)Game();		// Recreates the game.
+			simulation.RequestReset();
 		}
 
-		game.Update();
-		game.Draw( graphicsEngine );
-
-		// Slow down the game so that it is possible to see what is going on.
-		std::this_thread::sleep_for( std::chrono::milliseconds( 85 ) );		// TODO: Sleep shorter if the frame is longer.
+		// Draw the latest completed tick of the game.
+		if ( simulation.FetchSnapshot( snapshot ) ) {
+			gameRenderer.Draw( snapshot, graphicsEngine );
+		}
 
 		graphicsEngine.Swap();
 	}
 
 	return 0;	// Exit success.
-};
\ No newline at end of file
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+// Small, fast random number generator (splitmix64). Each game and player owns its own, so that games can run in parallel and are reproducible from their seed.
+class Random {
+public:
+	explicit					Random					( uint64_t seed = 0 ) : m_State( seed ) { }
+
+	uint64_t					Next					( );
+								// Uniform number in [0, bound), bound must be larger than 0.
+	uint32_t					NextBelow				( uint32_t bound );
+
+	uint64_t					GetState				( ) const	{ return m_State; }
+	void						SetState				( uint64_t state )	{ m_State = state; }
+
+private:
+	uint64_t					m_State;
+};
+
+inline uint64_t Random::Next() {
+	uint64_t z		= ( m_State += 0x9E3779B97F4A7C15ull );
+	z				= ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+	z				= ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+	return z ^ ( z >> 31 );
+}
+
+inline uint32_t Random::NextBelow( uint32_t bound ) {
+	return static_cast<uint32_t>( ( ( Next() & 0xFFFFFFFFull ) * bound ) >> 32 );		// Multiply-shift instead of modulo, avoids the division.
+}
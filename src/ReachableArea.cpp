@@ -0,0 +1,33 @@
+#include "ReachableArea.h"
+
+#include <algorithm>
+#include "GameState.h"
+
+size_t ReachableArea::Count( const GameState& gameState, size_t startTile, size_t maxCount ) {
+	return this->Fill( gameState, startTile, 0, maxCount, false );
+}
+
+size_t ReachableArea::CountTailAware( const GameState& gameState, size_t startTile, uint32_t startTick, size_t maxCount ) {
+	return this->Fill( gameState, startTile, startTick, maxCount, true );
+}
+
+size_t ReachableArea::Fill( const GameState& gameState, size_t startTile, uint32_t startTick, size_t maxCount, bool isTailAware ) {
+	if ( maxCount == 0 ) {
+		return 0;
+	}
+
+	// The start is reached even if it is blocked, like the head of a snake.
+	m_Search.Reset( gameState );
+	m_Search.AddSource( startTile );
+	size_t nrOfReachedTiles		= 1;
+
+	// Each level is entered one update after the last, and its tiles are counted until there is room enough.
+	uint32_t arrivalTick		= startTick;
+	while ( nrOfReachedTiles < maxCount && ( isTailAware ? m_Search.StepTailAware( gameState, ++arrivalTick ) : m_Search.Step() ) ) {
+		const std::vector<uint64_t>& frontier		= m_Search.GetFrontier();
+		for ( size_t wordIndex = m_Search.GetFirstWord(); wordIndex < m_Search.GetEndWord(); ++wordIndex ) {
+			nrOfReachedTiles							+= PopCount( frontier[wordIndex] );
+		}
+	}
+	return std::min( nrOfReachedTiles, maxCount );
+}
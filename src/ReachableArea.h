@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "BitBreadthFirstSearch.h"
+
+class GameState;
+
+// Counts the tiles that can be reached from a tile, to tell open space from dead end pockets. The count stops at a maximum, so asking
+// whether there is room for a snake costs time proportional to the length of the snake, not to the size of the board.
+// The search is a BitBreadthFirstSearch, which spreads a word at a time and only clears the words the last search touched.
+class ReachableArea {
+public:
+								// Number of tiles reachable from the start tile, counting itself, or maxCount if there are at least that many. Blocked tiles stay blocked.
+	size_t						Count					( const GameState& gameState, size_t startTile, size_t maxCount );
+								// Same as Count, but tiles blocked by snakes count as reachable if the snake has moved off them by the time they are reached.
+								// The start tile is entered in update startTick, the tiles next to it in the update after that, and so on. Tiles are reached as early as possible,
+								// so a tile that frees up after its neighbours were reached is only counted if it is next to tiles reached later.
+	size_t						CountTailAware			( const GameState& gameState, size_t startTile, uint32_t startTick, size_t maxCount );
+
+private:
+	size_t						Fill					( const GameState& gameState, size_t startTile, uint32_t startTick, size_t maxCount, bool isTailAware );
+
+	BitBreadthFirstSearch		m_Search;
+};
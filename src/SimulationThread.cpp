@@ -0,0 +1,92 @@
+#include "SimulationThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#define MAX_TICKS_BEHIND		5		// If the simulation falls further behind than this it gives up on catching up, instead of trying to run an ever growing number of ticks.
+
+SimulationThread::SimulationThread( double ticksPerSecond ) {
+	m_TicksPerSecond		= ticksPerSecond;
+	m_Thread				= std::thread( &SimulationThread::Run, this );
+}
+
+SimulationThread::~SimulationThread() {
+	m_Running		= false;
+	if ( m_Thread.joinable() ) {
+		m_Thread.join();
+	}
+}
+
+void SimulationThread::SetTicksPerSecond( double ticksPerSecond ) {
+	m_TicksPerSecond		= ticksPerSecond;
+}
+
+void SimulationThread::RequestReset() {
+	m_ResetRequested		= true;
+}
+
+bool SimulationThread::FetchSnapshot( GameSnapshot& outSnapshot ) {
+	{
+		std::lock_guard<std::mutex> lock( m_SnapshotMutex );
+		if ( !m_HasSnapshot ) {
+			return false;
+		}
+		if ( m_SharedSnapshotIsNew ) {
+			std::swap( outSnapshot, m_SharedSnapshot );		// Swapping hands over the buffers without copying the states.
+			m_SharedSnapshotIsNew		= false;
+		}
+	}
+	m_SnapshotRequested		= true;		// Ask for the next completed tick.
+	return true;
+}
+
+void SimulationThread::Run() {
+	using Clock = std::chrono::steady_clock;
+
+	uint64_t seed		= static_cast<uint64_t>( Clock::now().time_since_epoch().count() );		// Different game every time the program is started.
+	std::unique_ptr<Game> game( new Game( seed ) );
+	this->PublishSnapshot( *game );
+
+	Clock::time_point nextTickTime		= Clock::now();
+	while ( m_Running ) {
+		if ( m_ResetRequested.exchange( false ) ) {
+			game.reset( new Game( ++seed ) );
+			m_SnapshotRequested		= true;		// Show the new game immediately, even if the previous one hasn't been fetched.
+			this->PublishSnapshot( *game );
+		}
+
+		const double ticksPerSecond		= m_TicksPerSecond;
+		if ( ticksPerSecond > TICKS_PER_SECOND_UNCAPPED ) {
+			// Wait for the next tick, then schedule the following one a fixed time step later so that the tick rate doesn't drift with how long updates take.
+			const Clock::duration timeStep		= std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1.0 / ticksPerSecond ) );
+			const Clock::time_point now			= Clock::now();
+			if ( now < nextTickTime ) {
+				std::this_thread::sleep_until( std::min<Clock::time_point>( nextTickTime, now + std::chrono::milliseconds( 50 ) ) );		// Sleep in short steps so that stopping and rate changes are noticed quickly.
+				continue;
+			}
+			nextTickTime		+= timeStep;
+			if ( now - nextTickTime > MAX_TICKS_BEHIND * timeStep ) {
+				nextTickTime		= now + timeStep;
+			}
+		} else {
+			nextTickTime		= Clock::now();
+		}
+
+		game->Update();
+		this->PublishSnapshot( *game );
+	}
+}
+
+void SimulationThread::PublishSnapshot( const Game& game ) {
+	if ( !m_SnapshotRequested.exchange( false ) ) {
+		return;
+	}
+
+	game.CopySnapshot( m_BackSnapshot );		// Copied outside of the lock, so the reader is never blocked by the copy.
+
+	std::lock_guard<std::mutex> lock( m_SnapshotMutex );
+	std::swap( m_BackSnapshot, m_SharedSnapshot );
+	m_SharedSnapshotIsNew		= true;
+	m_HasSnapshot				= true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "Game.h"
+
+#define TICKS_PER_SECOND_UNCAPPED		0.0		// Tick rate that makes the simulation run as fast as possible.
+
+// Runs a game on its own thread at a fixed tick rate, independent of how fast it is drawn.
+// The latest completed tick can be fetched at any time from another thread without waiting for the simulation.
+class SimulationThread {
+public:
+								SimulationThread		( double ticksPerSecond );
+								~SimulationThread		( );
+
+	void						SetTicksPerSecond		( double ticksPerSecond );
+	void						RequestReset			( );
+
+								// Swaps in the latest completed tick if a newer one than the one held by outSnapshot exists. Returns false until the first tick is available.
+	bool						FetchSnapshot			( GameSnapshot& outSnapshot );
+
+private:
+	void						Run						( );
+	void						PublishSnapshot			( const Game& game );
+
+	std::thread					m_Thread;
+	std::atomic<bool>			m_Running				{ true };
+	std::atomic<bool>			m_ResetRequested		{ false };
+	std::atomic<double>			m_TicksPerSecond;
+
+	// Triple buffering: the simulation fills m_BackSnapshot and swaps it with m_SharedSnapshot, the reader swaps m_SharedSnapshot with its own snapshot.
+	// A new snapshot is only copied once the reader has taken the previous one, so an uncapped simulation doesn't spend its time copying states nobody draws.
+	std::mutex					m_SnapshotMutex;
+	GameSnapshot				m_BackSnapshot;
+	GameSnapshot				m_SharedSnapshot;
+	bool						m_SharedSnapshotIsNew	= false;
+	bool						m_HasSnapshot			= false;
+	std::atomic<bool>			m_SnapshotRequested		{ true };
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cassert>
+#include <glm/vec2.hpp>
+#include <vector>
+
+// Positions of a snakes body stored in a ring buffer, indexed from the head (0) to the tail (size() - 1).
+// Adding a head and removing the tail are O(1), unlike inserting at the front of a std::vector.
+class SnakeBody {
+public:
+	size_t						size					( ) const	{ return m_Size; }
+	bool						empty					( ) const	{ return m_Size == 0; }
+	size_t						capacity				( ) const	{ return m_Buffer.size(); }
+
+	const glm::ivec2&			operator[]				( size_t index ) const;
+	const glm::ivec2&			front					( ) const	{ return (*this)[0]; }
+	const glm::ivec2&			back					( ) const	{ return (*this)[m_Size - 1]; }
+
+	void						push_front				( const glm::ivec2& segment );
+	void						pop_back				( );
+								// The opposite ends, for undoing moves.
+	void						push_back				( const glm::ivec2& segment );
+	void						pop_front				( );
+	void						clear					( )			{ m_Head = 0; m_Size = 0; }
+
+								// Makes room for at least the given number of segments. Capacity is kept at a power of two so that indexing wraps with a mask.
+	void						reserve					( size_t nrOfSegments );
+
+private:
+	std::vector<glm::ivec2>		m_Buffer;
+	size_t						m_Head					= 0;		// Buffer index of the head segment.
+	size_t						m_Size					= 0;
+};
+
+inline const glm::ivec2& SnakeBody::operator[]( size_t index ) const {
+	assert( index < m_Size );
+	return m_Buffer[( m_Head + index ) & ( m_Buffer.size() - 1 )];
+}
+
+inline void SnakeBody::push_front( const glm::ivec2& segment ) {
+	if ( m_Size == m_Buffer.size() ) {
+		this->reserve( m_Size + 1 );
+	}
+	m_Head				= ( m_Head - 1 ) & ( m_Buffer.size() - 1 );		// Step the head backwards, wrapping around the buffer.
+	m_Buffer[m_Head]	= segment;
+	++m_Size;
+}
+
+inline void SnakeBody::pop_back() {
+	assert( m_Size > 0 );
+	--m_Size;
+}
+
+inline void SnakeBody::push_back( const glm::ivec2& segment ) {
+	if ( m_Size == m_Buffer.size() ) {
+		this->reserve( m_Size + 1 );
+	}
+	m_Buffer[( m_Head + m_Size ) & ( m_Buffer.size() - 1 )]		= segment;
+	++m_Size;
+}
+
+inline void SnakeBody::pop_front() {
+	assert( m_Size > 0 );
+	m_Head		= ( m_Head + 1 ) & ( m_Buffer.size() - 1 );
+	--m_Size;
+}
+
+inline void SnakeBody::reserve( size_t nrOfSegments ) {
+	if ( nrOfSegments <= m_Buffer.size() ) {
+		return;
+	}
+
+	size_t newCapacity		= m_Buffer.empty() ? 4 : m_Buffer.size();
+	while ( newCapacity < nrOfSegments ) {
+		newCapacity		*= 2;
+	}
+
+	// Unwrap the segments into the start of the new buffer, head first.
+	std::vector<glm::ivec2> newBuffer( newCapacity );
+	for ( size_t i = 0; i < m_Size; ++i ) {
+		newBuffer[i]		= (*this)[i];
+	}
+	m_Buffer.swap( newBuffer );
+	m_Head					= 0;
+}
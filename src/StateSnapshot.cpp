@@ -0,0 +1,230 @@
+#include "StateSnapshot.h"
+
+#include <cstring>
+#include "GameState.h"
+
+#define NO_TEAM		UINT32_MAX		// Team index of dead snakes in the snapshot.
+
+// Sections of the buffer, in the order they are placed after the header.
+enum SnapshotSection {
+	SECTION_BOARD,
+	SECTION_BLOCKED_BITS,
+	SECTION_OPEN_TILES,
+	SECTION_OPEN_TILE_SLOTS,
+	SECTION_TILE_SNAKE_IDS,
+	SECTION_TILE_SERIALS,
+	SECTION_FREE_TICK_OFFSETS,
+	SECTION_APPLES,
+	SECTION_CHANGED_TILES,
+	SECTION_TEAM_SIZES,
+	SECTION_SNAKES,
+	SECTION_SEGMENTS,
+	NR_OF_SECTIONS
+};
+
+struct SnapshotHeader {
+	uint32_t				SizeX;
+	uint32_t				SizeY;
+	uint64_t				BoardStride;
+	uint64_t				AppleRandomState;
+	uint64_t				Hash;
+	uint32_t				Tick;
+	uint32_t				NrOfTeams;
+	uint32_t				NrOfSnakes;						// Living snakes first, team by team, then the dead ones.
+	uint32_t				NrOfDeadSnakes;
+	uint64_t				Counts[NR_OF_SECTIONS];			// Number of elements in each section.
+	uint64_t				Offsets[NR_OF_SECTIONS];		// Byte offset of each section from the start of the buffer.
+};
+
+struct PackedSnake {
+	uint32_t				TeamIndex;						// NO_TEAM for dead snakes.
+	uint32_t				Id;
+	uint32_t				NrOfHeadsAdded;
+	uint32_t				NrOfSegments;
+	uint64_t				SegmentsToSpawn;
+};
+
+// Sections are rounded up to whole words, so that every section starts aligned.
+static size_t RoundUpToWord( size_t nrOfBytes ) {
+	return ( nrOfBytes + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t ) * sizeof( uint64_t );
+}
+
+// Copies a whole vector into a section. Empty vectors may have no data, so they are skipped.
+template<typename T>
+static void WriteSection( uint8_t* buffer, const SnapshotHeader& header, SnapshotSection section, const std::vector<T>& values ) {
+	if ( !values.empty() ) {
+		std::memcpy( buffer + header.Offsets[section], values.data(), values.size() * sizeof( T ) );
+	}
+}
+
+template<typename T>
+static void ReadSection( const uint8_t* buffer, const SnapshotHeader& header, SnapshotSection section, std::vector<T>& outValues ) {
+	outValues.resize( header.Counts[section] );
+	if ( !outValues.empty() ) {
+		std::memcpy( outValues.data(), buffer + header.Offsets[section], outValues.size() * sizeof( T ) );
+	}
+}
+
+static void PackSnake( uint8_t* buffer, const SnapshotHeader& header, size_t snakeIndex, size_t& segmentIndex, const Snake& snake, uint32_t teamIndex ) {
+	const PackedSnake packedSnake		= { teamIndex, snake.Id, snake.NrOfHeadsAdded, static_cast<uint32_t>( snake.Segments.size() ), snake.SegmentsToSpawn };
+	std::memcpy( buffer + header.Offsets[SECTION_SNAKES] + snakeIndex * sizeof( PackedSnake ), &packedSnake, sizeof( PackedSnake ) );
+
+	// The body is a ring buffer, so it is unwrapped from head to tail.
+	for ( size_t i = 0; i < snake.Segments.size(); ++i ) {
+		std::memcpy( buffer + header.Offsets[SECTION_SEGMENTS] + segmentIndex++ * sizeof( glm::ivec2 ), &snake.Segments[i], sizeof( glm::ivec2 ) );
+	}
+}
+
+static void UnpackSnake( const uint8_t* buffer, const SnapshotHeader& header, size_t snakeIndex, size_t& segmentIndex, Snake& outSnake ) {
+	PackedSnake packedSnake;
+	std::memcpy( &packedSnake, buffer + header.Offsets[SECTION_SNAKES] + snakeIndex * sizeof( PackedSnake ), sizeof( PackedSnake ) );
+	outSnake.Id					= packedSnake.Id;
+	outSnake.NrOfHeadsAdded		= packedSnake.NrOfHeadsAdded;
+	outSnake.SegmentsToSpawn	= static_cast<size_t>( packedSnake.SegmentsToSpawn );
+
+	// Heads are pushed to the front, so the body is rebuilt from the tail. Room is made for the pending growth like GameState::AddSnakeHead does.
+	outSnake.Segments.clear();
+	outSnake.Segments.reserve( packedSnake.NrOfSegments + outSnake.SegmentsToSpawn );
+	segmentIndex			+= packedSnake.NrOfSegments;
+	for ( size_t i = 1; i <= packedSnake.NrOfSegments; ++i ) {
+		glm::ivec2 segment;
+		std::memcpy( &segment, buffer + header.Offsets[SECTION_SEGMENTS] + ( segmentIndex - i ) * sizeof( glm::ivec2 ), sizeof( glm::ivec2 ) );
+		outSnake.Segments.push_front( segment );
+	}
+}
+
+void StateSnapshot::Capture( const GameState& gameState ) {
+	SnapshotHeader header;
+	header.SizeX				= gameState.Size.x;
+	header.SizeY				= gameState.Size.y;
+	header.BoardStride			= gameState.BoardStride;
+	header.AppleRandomState		= gameState.AppleRandom.GetState();
+	header.Hash					= gameState.Hash;
+	header.Tick					= gameState.Tick;
+	header.NrOfTeams			= static_cast<uint32_t>( gameState.Teams.size() );
+	header.NrOfDeadSnakes		= static_cast<uint32_t>( gameState.DeadSnakes.size() );
+	header.NrOfSnakes			= header.NrOfDeadSnakes;
+	size_t nrOfSegments			= 0;
+	for ( const auto& team : gameState.Teams ) {
+		header.NrOfSnakes		+= static_cast<uint32_t>( team.Snakes.size() );
+		for ( const auto& snake : team.Snakes ) {
+			nrOfSegments		+= snake.Segments.size();
+		}
+	}
+	for ( const auto& deadSnake : gameState.DeadSnakes ) {
+		nrOfSegments			+= deadSnake.Segments.size();
+	}
+
+	// Lay out the sections one after the other.
+	const size_t elementSizes[NR_OF_SECTIONS]		= { sizeof( Tile ), sizeof( uint64_t ), sizeof( uint32_t ), sizeof( uint32_t ), sizeof( uint32_t ), sizeof( uint32_t ), sizeof( uint32_t ),
+														sizeof( glm::ivec2 ), sizeof( uint32_t ), sizeof( uint32_t ), sizeof( PackedSnake ), sizeof( glm::ivec2 ) };
+	header.Counts[SECTION_BOARD]				= gameState.Board.size();
+	header.Counts[SECTION_BLOCKED_BITS]			= gameState.BlockedBits.size();
+	header.Counts[SECTION_OPEN_TILES]			= gameState.OpenTiles.size();
+	header.Counts[SECTION_OPEN_TILE_SLOTS]		= gameState.OpenTileSlots.size();
+	header.Counts[SECTION_TILE_SNAKE_IDS]		= gameState.TileSnakeIds.size();
+	header.Counts[SECTION_TILE_SERIALS]			= gameState.TileSerials.size();
+	header.Counts[SECTION_FREE_TICK_OFFSETS]	= gameState.FreeTickOffsets.size();
+	header.Counts[SECTION_APPLES]				= gameState.Apples.size();
+	header.Counts[SECTION_CHANGED_TILES]		= gameState.ChangedTiles.size();
+	header.Counts[SECTION_TEAM_SIZES]			= gameState.Teams.size();
+	header.Counts[SECTION_SNAKES]				= header.NrOfSnakes;
+	header.Counts[SECTION_SEGMENTS]				= nrOfSegments;
+	size_t nrOfBytes		= RoundUpToWord( sizeof( SnapshotHeader ) );
+	for ( size_t section = 0; section < NR_OF_SECTIONS; ++section ) {
+		header.Offsets[section]		= nrOfBytes;
+		nrOfBytes					+= RoundUpToWord( header.Counts[section] * elementSizes[section] );
+	}
+	m_Buffer.resize( nrOfBytes / sizeof( uint64_t ) );
+
+	uint8_t* buffer		= reinterpret_cast<uint8_t*>( m_Buffer.data() );
+	std::memcpy( buffer, &header, sizeof( SnapshotHeader ) );
+	WriteSection( buffer, header, SECTION_BOARD,				gameState.Board );
+	WriteSection( buffer, header, SECTION_BLOCKED_BITS,			gameState.BlockedBits );
+	WriteSection( buffer, header, SECTION_OPEN_TILES,			gameState.OpenTiles );
+	WriteSection( buffer, header, SECTION_OPEN_TILE_SLOTS,		gameState.OpenTileSlots );
+	WriteSection( buffer, header, SECTION_TILE_SNAKE_IDS,		gameState.TileSnakeIds );
+	WriteSection( buffer, header, SECTION_TILE_SERIALS,			gameState.TileSerials );
+	WriteSection( buffer, header, SECTION_FREE_TICK_OFFSETS,	gameState.FreeTickOffsets );
+	WriteSection( buffer, header, SECTION_APPLES,				gameState.Apples );
+	WriteSection( buffer, header, SECTION_CHANGED_TILES,		gameState.ChangedTiles );
+
+	size_t snakeIndex		= 0;
+	size_t segmentIndex		= 0;
+	for ( size_t teamIndex = 0; teamIndex < gameState.Teams.size(); ++teamIndex ) {
+		const uint32_t teamSize		= static_cast<uint32_t>( gameState.Teams[teamIndex].Snakes.size() );
+		std::memcpy( buffer + header.Offsets[SECTION_TEAM_SIZES] + teamIndex * sizeof( uint32_t ), &teamSize, sizeof( uint32_t ) );
+		for ( const auto& snake : gameState.Teams[teamIndex].Snakes ) {
+			PackSnake( buffer, header, snakeIndex++, segmentIndex, snake, static_cast<uint32_t>( teamIndex ) );
+		}
+	}
+	for ( const auto& deadSnake : gameState.DeadSnakes ) {
+		PackSnake( buffer, header, snakeIndex++, segmentIndex, deadSnake, NO_TEAM );
+	}
+}
+
+void StateSnapshot::Restore( GameState& outState ) const {
+	assert( !m_Buffer.empty() );
+	const uint8_t* buffer		= reinterpret_cast<const uint8_t*>( m_Buffer.data() );
+	SnapshotHeader header;
+	std::memcpy( &header, buffer, sizeof( SnapshotHeader ) );
+
+	outState.Size				= glm::uvec2( header.SizeX, header.SizeY );
+	outState.BoardStride		= static_cast<size_t>( header.BoardStride );
+	outState.AppleRandom.SetState( header.AppleRandomState );
+	outState.Hash				= header.Hash;
+	outState.Tick				= header.Tick;
+	ReadSection( buffer, header, SECTION_BOARD,					outState.Board );
+	ReadSection( buffer, header, SECTION_BLOCKED_BITS,			outState.BlockedBits );
+	ReadSection( buffer, header, SECTION_OPEN_TILES,			outState.OpenTiles );
+	ReadSection( buffer, header, SECTION_OPEN_TILE_SLOTS,		outState.OpenTileSlots );
+	ReadSection( buffer, header, SECTION_TILE_SNAKE_IDS,		outState.TileSnakeIds );
+	ReadSection( buffer, header, SECTION_TILE_SERIALS,			outState.TileSerials );
+	ReadSection( buffer, header, SECTION_FREE_TICK_OFFSETS,		outState.FreeTickOffsets );
+	ReadSection( buffer, header, SECTION_APPLES,				outState.Apples );
+	ReadSection( buffer, header, SECTION_CHANGED_TILES,			outState.ChangedTiles );
+	outState.AppleCells.Reset( outState.Size, outState.Apples );		// A few apples, cheaper to index again than to store the grid.
+
+	// Snakes that the destination already has keep their body buffers, so only snakes it lacks allocate.
+	size_t snakeIndex		= 0;
+	size_t segmentIndex		= 0;
+	outState.Teams.resize( header.NrOfTeams );
+	for ( size_t teamIndex = 0; teamIndex < header.NrOfTeams; ++teamIndex ) {
+		uint32_t teamSize;
+		std::memcpy( &teamSize, buffer + header.Offsets[SECTION_TEAM_SIZES] + teamIndex * sizeof( uint32_t ), sizeof( uint32_t ) );
+		outState.Teams[teamIndex].Snakes.resize( teamSize );
+		for ( auto& snake : outState.Teams[teamIndex].Snakes ) {
+			UnpackSnake( buffer, header, snakeIndex++, segmentIndex, snake );
+		}
+	}
+	outState.DeadSnakes.resize( header.NrOfDeadSnakes );
+	for ( auto& deadSnake : outState.DeadSnakes ) {
+		UnpackSnake( buffer, header, snakeIndex++, segmentIndex, deadSnake );
+	}
+}
+
+void StateSnapshot::CopyTo( StateSnapshot& outSnapshot ) const {
+	if ( &outSnapshot == this ) {
+		return;
+	}
+	outSnapshot.m_Buffer.resize( m_Buffer.size() );
+	std::memcpy( outSnapshot.m_Buffer.data(), m_Buffer.data(), m_Buffer.size() * sizeof( uint64_t ) );
+}
+
+size_t StateSnapshot::GetSizeInBytes() const {
+	return m_Buffer.size() * sizeof( uint64_t );
+}
+
+StateSnapshot* StateSnapshotPool::Acquire() {
+	if ( m_FreeSnapshots.empty() ) {
+		m_Snapshots.emplace_back( new StateSnapshot() );
+		return m_Snapshots.back().get();
+	}
+	StateSnapshot* snapshot		= m_FreeSnapshots.back();
+	m_FreeSnapshots.pop_back();
+	return snapshot;
+}
+
+void StateSnapshotPool::Release( StateSnapshot* snapshot ) {
+	m_FreeSnapshots.push_back( snapshot );
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class GameState;
+
+// Copy of everything the game rules read and write in a GameState, packed into one contiguous buffer: the board and its bitboard, the tile bookkeeping,
+// every snake with its body, the apples and the random state. Copying a snapshot is a single memcpy into a buffer that is kept between copies,
+// unlike copying a GameState, which copies every team, snake and body on its own.
+// The maps that are built once per tick (GameState::AppleFlow and GameState::Territory) are not part of the snapshot. Restore leaves them as they are in the destination.
+class StateSnapshot {
+public:
+								// Packs the state into the snapshot, reusing the buffer if it is large enough.
+	void						Capture					( const GameState& gameState );
+								// Unpacks the snapshot into a state, reusing the memory already allocated by it.
+	void						Restore					( GameState& outState ) const;
+								// Single copy of the buffer.
+	void						CopyTo					( StateSnapshot& outSnapshot ) const;
+
+	size_t						GetSizeInBytes			( ) const;
+
+private:
+	std::vector<uint64_t>		m_Buffer;				// A header followed by the sections it describes. 64 bit words keep every section aligned.
+};
+
+// Keeps snapshots for reuse, so that searches storing many states don't allocate a buffer for each one. Not thread safe, each thread should have its own pool.
+class StateSnapshotPool {
+public:
+								// Returns a snapshot holding whatever was captured into it last, or a new empty one.
+	StateSnapshot*				Acquire					( );
+	void						Release					( StateSnapshot* snapshot );
+
+private:
+	std::vector<std::unique_ptr<StateSnapshot>>		m_Snapshots;		// Every snapshot the pool has made.
+	std::vector<StateSnapshot*>						m_FreeSnapshots;
+};
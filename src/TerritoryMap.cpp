@@ -0,0 +1,75 @@
+#include "TerritoryMap.h"
+
+#include "GameState.h"
+
+void TerritoryMap::Update( const GameState& gameState ) {
+	if ( m_Tick == gameState.Tick && m_Hash == gameState.Hash && m_Owners.size() == gameState.Board.size() ) {
+		return;
+	}
+	m_Tick		= gameState.Tick;
+	m_Hash		= gameState.Hash;
+	const size_t nrOfSnakeIds		= gameState.FreeTickOffsets.size();
+	m_Owners.assign( gameState.Board.size(), NO_OWNER );
+	m_Distances.assign( gameState.Board.size(), UNREACHED );
+	m_SnakeAreas.assign( nrOfSnakeIds, 0 );
+	m_SnakeApples.assign( nrOfSnakeIds, 0 );
+	m_SnakeTeams.assign( nrOfSnakeIds, 0 );
+	m_TeamAreas.assign( gameState.Teams.size(), 0 );
+	m_TeamApples.assign( gameState.Teams.size(), 0 );
+
+	// Every living snake starts from its head. Heads are blocked, so no other snake reaches them.
+	m_Search.Reset( gameState );
+	for ( size_t teamIndex = 0; teamIndex < gameState.Teams.size(); ++teamIndex ) {
+		for ( const Snake& snake : gameState.Teams[teamIndex].Snakes ) {
+			const size_t headTile		= gameState.GetTileIndex( snake.Segments[0] );
+			m_SnakeTeams[snake.Id]		= static_cast<uint32_t>( teamIndex );
+			m_Owners[headTile]			= snake.Id;
+			m_Distances[headTile]		= 0;
+			m_Search.AddSource( headTile );
+		}
+	}
+
+	// Every snake moves one tile further in each level, until nobody can get any further. Each newly reached tile goes to the snake it was reached from.
+	// Contested tiles are reached too, but are taken out of the frontier so that they don't spread any further.
+	const int stride			= static_cast<int>( gameState.BoardStride );
+	while ( m_Search.Step() ) {
+		const std::vector<uint64_t>& frontier		= m_Search.GetFrontier();
+		for ( size_t wordIndex = m_Search.GetFirstWord(); wordIndex < m_Search.GetEndWord(); ++wordIndex ) {
+			for ( uint64_t bits = frontier[wordIndex]; bits != 0; bits &= bits - 1 ) {
+				const size_t tile		= wordIndex * BITS_PER_WORD + CountTrailingZeros( bits );
+				const uint32_t owner	= this->FindSpreadingOwner( tile, stride );
+				m_Owners[tile]			= owner;
+				m_Distances[tile]		= m_Search.GetLevel();
+				if ( owner == NO_OWNER ) {
+					m_Search.RemoveFromFrontier( tile );
+				} else {
+					++m_SnakeAreas[owner];
+					++m_TeamAreas[m_SnakeTeams[owner]];
+				}
+			}
+		}
+	}
+
+	for ( const auto& apple : gameState.Apples ) {
+		const uint32_t owner		= m_Owners[gameState.GetTileIndex( apple )];
+		if ( owner != NO_OWNER ) {
+			++m_SnakeApples[owner];
+			++m_TeamApples[m_SnakeTeams[owner]];
+		}
+	}
+}
+
+uint32_t TerritoryMap::FindSpreadingOwner( size_t tileIndex, int stride ) const {
+	// The neighbours in the frontier all reached it in the same level, so they decide the owner together.
+	uint32_t owner		= NO_OWNER;
+	for ( int offset : { -stride, -1, 1, stride } ) {
+		const size_t neighbour		= static_cast<size_t>( static_cast<int>( tileIndex ) + offset );		// Reached tiles are open, so the blocked border keeps neighbours on the board.
+		if ( m_Search.IsInPreviousFrontier( neighbour ) ) {
+			if ( owner != NO_OWNER && owner != m_Owners[neighbour] ) {
+				return NO_OWNER;
+			}
+			owner		= m_Owners[neighbour];
+		}
+	}
+	return owner;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BitBreadthFirstSearch.h"
+
+#define NO_OWNER		UINT32_MAX		// Owner of tiles that no snake reaches, or that several snakes reach in the same move.
+
+class GameState;
+
+// Which snake reaches each tile first, found with one breadth first search from the heads of all living snakes at once. Tells each snake and team how much room
+// and how many apples it controls. Depends only on the board, so one map serves all teams.
+// The frontiers of all snakes share one BitBreadthFirstSearch, which spreads a word at a time. Only the newly reached tiles are looked at one by one,
+// to take the owner of the tiles they were reached from. Tiles reached by several snakes in the same move belong to nobody and stop all of them.
+// Tiles blocked now stay blocked, even if their snake will have moved off by the time they are reached.
+class TerritoryMap {
+public:
+								// Rebuilds the map for the board as it is now. Does nothing if it was already built for the state, judged by its tick and hash.
+	void						Update					( const GameState& gameState );
+
+								// Id of the snake that reaches the tile first, or NO_OWNER. Heads are owned by their snake.
+	uint32_t					GetOwner				( size_t tileIndex ) const;
+								// Number of moves the closest snakes need to reach the tile, or UNREACHED.
+	uint32_t					GetDistance				( size_t tileIndex ) const;
+								// Number of tiles owned by the snake or team, not counting heads.
+	size_t						GetSnakeArea			( uint32_t snakeId ) const;
+	size_t						GetTeamArea				( size_t teamIndex ) const;
+								// Number of apples on tiles owned by the snake or team.
+	size_t						GetSnakeApples			( uint32_t snakeId ) const;
+	size_t						GetTeamApples			( size_t teamIndex ) const;
+
+private:
+	uint32_t					FindSpreadingOwner		( size_t tileIndex, int stride ) const;
+
+	std::vector<uint32_t>		m_Owners;										// One entry per tile of the board.
+	std::vector<uint32_t>		m_Distances;									// One entry per tile of the board.
+	std::vector<size_t>			m_SnakeAreas;									// Per snake id.
+	std::vector<size_t>			m_SnakeApples;									// Per snake id.
+	std::vector<size_t>			m_TeamAreas;									// Per team index.
+	std::vector<size_t>			m_TeamApples;									// Per team index.
+	std::vector<uint32_t>		m_SnakeTeams;									// Team index per snake id.
+	BitBreadthFirstSearch		m_Search;										// Its frontiers only hold owned tiles.
+	uint32_t					m_Tick					= UINT32_MAX;			// Tick the map was built at, UINT32_MAX before the first update.
+	uint64_t					m_Hash					= 0;					// Hash of the state the map was built for. Searches build maps of many states with the same tick.
+};
+
+inline uint32_t TerritoryMap::GetOwner( size_t tileIndex ) const {
+	return m_Owners[tileIndex];
+}
+
+inline uint32_t TerritoryMap::GetDistance( size_t tileIndex ) const {
+	return m_Distances[tileIndex];
+}
+
+inline size_t TerritoryMap::GetSnakeArea( uint32_t snakeId ) const {
+	return m_SnakeAreas[snakeId];
+}
+
+inline size_t TerritoryMap::GetTeamArea( size_t teamIndex ) const {
+	return m_TeamAreas[teamIndex];
+}
+
+inline size_t TerritoryMap::GetSnakeApples( uint32_t snakeId ) const {
+	return m_SnakeApples[snakeId];
+}
+
+inline size_t TerritoryMap::GetTeamApples( size_t teamIndex ) const {
+	return m_TeamApples[teamIndex];
+}
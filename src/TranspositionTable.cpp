@@ -0,0 +1,60 @@
+#include "TranspositionTable.h"
+
+#include <cstring>
+#include <type_traits>
+
+static_assert( sizeof( TranspositionEntry ) == sizeof( uint64_t ) && std::is_trivial<TranspositionEntry>::value, "Entries must pack into one word." );
+
+static uint64_t PackEntry( const TranspositionEntry& entry ) {
+	uint64_t data;
+	std::memcpy( &data, &entry, sizeof( data ) );
+	return data;
+}
+
+static TranspositionEntry UnpackEntry( uint64_t data ) {
+	TranspositionEntry entry{};
+	std::memcpy( &entry, &data, sizeof( entry ) );
+	return entry;
+}
+
+TranspositionTable::TranspositionTable( size_t sizeInBytes ) {
+	size_t nrOfSlots		= 1;
+	while ( nrOfSlots * 2 * sizeof( Slot ) <= sizeInBytes ) {
+		nrOfSlots			*= 2;
+	}
+	m_Slots.reset( new Slot[nrOfSlots] );
+	m_SlotMask				= nrOfSlots - 1;
+}
+
+bool TranspositionTable::Probe( uint64_t hash, TranspositionEntry& outEntry ) const {
+	const Slot& slot			= m_Slots[hash & m_SlotMask];
+	const uint64_t data			= slot.Data.load( std::memory_order_relaxed );
+	const uint64_t keyXorData	= slot.KeyXorData.load( std::memory_order_relaxed );
+	if ( ( keyXorData ^ data ) != hash || ( keyXorData == 0 && data == 0 ) ) {		// An empty slot only matches the hash zero, which is no state then.
+		return false;
+	}
+	outEntry					= UnpackEntry( data );
+	return true;
+}
+
+void TranspositionTable::Store( uint64_t hash, const TranspositionEntry& entry ) {
+	Slot& slot					= m_Slots[hash & m_SlotMask];
+	TranspositionEntry stored{};
+	if ( this->Probe( hash, stored ) && stored.Generation == entry.Generation && stored.Depth > entry.Depth ) {
+		return;
+	}
+	const uint64_t data			= PackEntry( entry );
+	slot.KeyXorData.store( hash ^ data, std::memory_order_relaxed );
+	slot.Data.store( data, std::memory_order_relaxed );
+}
+
+void TranspositionTable::Clear() {
+	for ( size_t slotIndex = 0; slotIndex <= m_SlotMask; ++slotIndex ) {
+		m_Slots[slotIndex].KeyXorData.store( 0, std::memory_order_relaxed );
+		m_Slots[slotIndex].Data.store( 0, std::memory_order_relaxed );
+	}
+}
+
+size_t TranspositionTable::GetNrOfSlots() const {
+	return m_SlotMask + 1;
+}
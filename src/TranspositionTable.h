@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define TRANSPOSITION_TABLE_DEFAULT_SIZE	( size_t( 16 ) << 20 )		// Bytes used by a table unless told otherwise.
+
+// How the value of an entry relates to the true value of the state, for searches that cut off branches.
+enum class TranspositionBound : uint8_t {
+	Exact,
+	Lower,		// The true value is at least the value.
+	Upper		// The true value is at most the value.
+};
+
+// What a search found out about a state. Packed into 64 bits, so that a whole entry is written and read with one atomic operation.
+// Trivial, so that it can be copied to and from a word with memcpy. Value-initialize it with {} to start from zero.
+struct TranspositionEntry {
+	float					Value;
+	uint8_t					BestMoves;			// Two bits per snake for up to four snakes, holding a Move, the first snake in the lowest bits.
+	uint8_t					Depth;				// Number of ticks searched below the state.
+	TranspositionBound		Bound;
+	uint8_t					Generation;			// Set by the search that stored the entry. Values from older searches may no longer hold, while their moves still make good guesses.
+};
+
+// Fixed size hash table from GameState::Hash to what a search found out about the state, shared by any number of threads without locks.
+// Each slot stores the hash xored with the entry next to the entry itself. If two threads write a slot at once and the halves end up from different writes, the check
+// on probing fails and the probe misses, instead of returning another states entry. Searches that value states differently should xor their own key into the hashes.
+class TranspositionTable {
+public:
+								// The size is rounded down to a power of two number of slots.
+	explicit					TranspositionTable		( size_t sizeInBytes = TRANSPOSITION_TABLE_DEFAULT_SIZE );
+
+								// Returns false if the table holds nothing about the state.
+	bool						Probe					( uint64_t hash, TranspositionEntry& outEntry ) const;
+								// Keeps a deeper entry of the same state and generation, otherwise replaces whatever is in the slot.
+	void						Store					( uint64_t hash, const TranspositionEntry& entry );
+								// Not thread safe, no other thread may use the table meanwhile.
+	void						Clear					( );
+
+	size_t						GetNrOfSlots			( ) const;
+
+private:
+	struct Slot {
+		std::atomic<uint64_t>	KeyXorData				{ 0 };
+		std::atomic<uint64_t>	Data					{ 0 };
+	};
+
+	std::unique_ptr<Slot[]>		m_Slots;
+	size_t						m_SlotMask;				// Number of slots minus one.
+};
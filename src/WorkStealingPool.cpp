@@ -0,0 +1,127 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool( size_t nrOfThreads ) {
+	if ( nrOfThreads == 0 ) {
+		nrOfThreads		= std::thread::hardware_concurrency();
+	}
+	if ( nrOfThreads == 0 ) {		// Hardware concurrency is allowed to be unknown.
+		nrOfThreads		= 1;
+	}
+
+	for ( size_t workerIndex = 0; workerIndex < nrOfThreads; ++workerIndex ) {
+		m_Ranges.emplace_back( new TaskRange() );
+	}
+	if ( nrOfThreads == 1 ) {		// The calling thread runs the tasks itself.
+		return;
+	}
+	for ( size_t workerIndex = 0; workerIndex < nrOfThreads; ++workerIndex ) {
+		m_Threads.emplace_back( &WorkStealingPool::WorkerLoop, this, workerIndex );
+	}
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_Stopping		= true;
+	}
+	m_WorkAvailable.notify_all();
+	for ( auto& thread : m_Threads ) {
+		thread.join();
+	}
+}
+
+size_t WorkStealingPool::GetNrOfThreads() const {
+	return m_Ranges.size();
+}
+
+void WorkStealingPool::Run( size_t nrOfTasks, const Task& task ) {
+	if ( nrOfTasks == 0 ) {
+		return;
+	}
+	if ( m_Threads.empty() ) {
+		for ( size_t taskIndex = 0; taskIndex < nrOfTasks; ++taskIndex ) {
+			task( taskIndex, 0 );
+		}
+		return;
+	}
+
+	// Give each worker an equally sized range of the tasks.
+	const size_t nrOfWorkers		= m_Ranges.size();
+	for ( size_t workerIndex = 0; workerIndex < nrOfWorkers; ++workerIndex ) {
+		TaskRange& range		= *m_Ranges[workerIndex];
+		std::lock_guard<std::mutex> lock( range.Mutex );
+		range.Begin				= nrOfTasks * workerIndex / nrOfWorkers;
+		range.End				= nrOfTasks * ( workerIndex + 1 ) / nrOfWorkers;
+	}
+
+	std::unique_lock<std::mutex> lock( m_Mutex );
+	m_Task					= &task;
+	m_NrOfWorkersBusy		= nrOfWorkers;
+	++m_Batch;
+	m_WorkAvailable.notify_all();
+	m_WorkDone.wait( lock, [this] { return m_NrOfWorkersBusy == 0; } );
+	m_Task					= nullptr;
+}
+
+void WorkStealingPool::WorkerLoop( size_t workerIndex ) {
+	size_t lastBatch		= 0;
+	while ( true ) {
+		const Task* task;
+		{
+			std::unique_lock<std::mutex> lock( m_Mutex );
+			m_WorkAvailable.wait( lock, [this, lastBatch] { return m_Stopping || m_Batch != lastBatch; } );
+			if ( m_Stopping ) {
+				return;
+			}
+			lastBatch		= m_Batch;
+			task			= m_Task;
+		}
+
+		// Run own tasks, then help the others until no tasks are left anywhere.
+		size_t taskIndex;
+		while ( this->PopTask( workerIndex, taskIndex ) || ( this->StealTasks( workerIndex ) && this->PopTask( workerIndex, taskIndex ) ) ) {
+			(*task)( taskIndex, workerIndex );
+		}
+
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		if ( --m_NrOfWorkersBusy == 0 ) {
+			m_WorkDone.notify_one();
+		}
+	}
+}
+
+bool WorkStealingPool::PopTask( size_t workerIndex, size_t& outTaskIndex ) {
+	TaskRange& range		= *m_Ranges[workerIndex];
+	std::lock_guard<std::mutex> lock( range.Mutex );
+	if ( range.Begin == range.End ) {
+		return false;
+	}
+	outTaskIndex		= --range.End;		// Own tasks are taken from the back, thieves take from the front.
+	return true;
+}
+
+bool WorkStealingPool::StealTasks( size_t workerIndex ) {
+	const size_t nrOfWorkers		= m_Ranges.size();
+	for ( size_t offset = 1; offset < nrOfWorkers; ++offset ) {
+		TaskRange& victim		= *m_Ranges[( workerIndex + offset ) % nrOfWorkers];
+		size_t stolenBegin;
+		size_t stolenEnd;
+		{
+			std::lock_guard<std::mutex> lock( victim.Mutex );
+			const size_t nrOfTasksLeft		= victim.End - victim.Begin;
+			if ( nrOfTasksLeft == 0 ) {
+				continue;
+			}
+			stolenBegin			= victim.Begin;
+			stolenEnd			= victim.Begin + ( nrOfTasksLeft + 1 ) / 2;		// Take half, rounded up so that a single task can be stolen.
+			victim.Begin		= stolenEnd;
+		}
+
+		TaskRange& range		= *m_Ranges[workerIndex];
+		std::lock_guard<std::mutex> lock( range.Mutex );
+		range.Begin				= stolenBegin;
+		range.End				= stolenEnd;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run batches of indexed tasks.
+// A pool of one thread starts no threads at all and runs the tasks on the thread that calls Run, so that players inside parallel batches cost nothing extra.
+// Each worker starts with an even share of the task indices and takes tasks from the back of it. A worker that runs out steals half of the remaining tasks of another worker, so uneven task lengths still keep every core busy.
+class WorkStealingPool {
+public:
+	using Task		= std::function<void( size_t taskIndex, size_t workerIndex )>;
+
+	explicit					WorkStealingPool		( size_t nrOfThreads = 0 );		// Zero uses one thread per hardware thread.
+								~WorkStealingPool		( );
+
+	size_t						GetNrOfThreads			( ) const;
+
+								// Runs task for every index in [0, nrOfTasks) and returns once all of them are done. Not reentrant.
+	void						Run						( size_t nrOfTasks, const Task& task );
+
+private:
+	struct TaskRange {
+		std::mutex				Mutex;
+		size_t					Begin					= 0;
+		size_t					End						= 0;
+	};
+
+	void						WorkerLoop				( size_t workerIndex );
+	bool						PopTask					( size_t workerIndex, size_t& outTaskIndex );
+	bool						StealTasks				( size_t workerIndex );
+
+	std::vector<std::thread>					m_Threads;
+	std::vector<std::unique_ptr<TaskRange>>		m_Ranges;						// One per worker, pointers since mutexes can't be moved.
+
+	std::mutex					m_Mutex;
+	std::condition_variable		m_WorkAvailable;
+	std::condition_variable		m_WorkDone;
+	const Task*					m_Task					= nullptr;
+	size_t						m_Batch					= 0;		// Increased for every call to Run, tells sleeping workers that there is new work.
+	size_t						m_NrOfWorkersBusy		= 0;
+	bool						m_Stopping				= false;
+};
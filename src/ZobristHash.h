@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#define ZOBRIST_SEED		0x2545F4914F6CDD1Dull		// Mixed into every key. Fixed, so that every state and thread agrees on the hashes.
+
+// The kinds of feature that GameState::Hash is made of.
+enum class ZobristFeature : uint64_t {
+	Tile				= 1,		// Index is the tile index, value is the Tile.
+	Head				= 2,		// Index is the snake id, value is the tile index of the head.
+	SegmentsToSpawn		= 3,		// Index is the snake id, value is the number of segments.
+	SearchNode			= 4			// Not part of GameState::Hash. Xored into it by searches to tell apart nodes that share a state, index and value are up to the search.
+};
+
+// Zobrist key of a feature of a game state. Instead of looking the key up in a table of random numbers, the feature is packed into a number and mixed with the
+// splitmix64 finalizer. The finalizer is a bijection, so distinct features never share a key, and no tables sized by the board are needed.
+inline uint64_t ZobristKey( ZobristFeature feature, uint64_t index, uint64_t value ) {
+	assert( index < ( uint64_t( 1 ) << 32 ) && value < ( uint64_t( 1 ) << 24 ) );
+	uint64_t z		= ZOBRIST_SEED ^ ( ( static_cast<uint64_t>( feature ) << 56 ) | ( index << 24 ) | value );
+	z				= ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+	z				= ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+	return z ^ ( z >> 31 );
+}
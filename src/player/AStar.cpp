@@ -0,0 +1,141 @@
+#include "AStar.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <glm/common.hpp>
+
+void AStar::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+	const Team& team		= currentState.Teams[teamIndex];
+	this->ResizeBuffers( currentState );
+
+	// Start a new set of reservations. When the stamp wraps around, old stamps could be mistaken for new ones, so they are cleared.
+	if ( ++m_ReserveStamp == 0 ) {
+		std::fill( m_ReservedStamps.begin(), m_ReservedStamps.end(), 0 );
+		m_ReserveStamp		= 1;
+	}
+
+	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+		const glm::ivec2& snakeTile		= team.Snakes[snakeIndex].Segments[0];
+		const uint32_t headTile			= static_cast<uint32_t>( currentState.GetTileIndex( snakeTile ) );
+
+		// Walk towards the closest apple, or make any safe move if there is no apple or no path to it.
+		glm::ivec2 targetApple;
+		uint32_t nextTile;
+		if ( currentState.FindClosestApple( glm::vec2( snakeTile ), FLT_MAX, targetApple ) &&
+			 this->FindPath( currentState, headTile, static_cast<uint32_t>( currentState.GetTileIndex( targetApple ) ), nextTile ) ) {
+			const int offset		= static_cast<int>( nextTile ) - static_cast<int>( headTile );
+			outMoves[snakeIndex]	= offset == -1 ? Move::Left : offset == 1 ? Move::Right : offset < 0 ? Move::Up : Move::Down;
+		} else {
+			outMoves[snakeIndex]	= this->ChooseFallbackMove( currentState, headTile, outMoves[snakeIndex] );
+		}
+
+		// Reserve the tile so that team mates don't plan to move onto it as well.
+		const glm::ivec2 movingTo									= snakeTile + ConvertMoveToIVec2( outMoves[snakeIndex] );
+		m_ReservedStamps[currentState.GetTileIndex( movingTo )]		= m_ReserveStamp;
+	}
+}
+
+size_t AStar::GetNrOfExpandedNodes() const {
+	return m_NrOfExpandedNodes;
+}
+
+bool AStar::FindPath( const GameState& gameState, uint32_t start, uint32_t goal, uint32_t& outFirstStep ) {
+	if ( start == goal ) {
+		return false;
+	}
+	this->ResizeBuffers( gameState );
+
+	// Start a new search. Each search uses two stamp values, so the stamp is advanced by two and the stamps are cleared if that wraps around.
+	if ( m_SearchStamp >= UINT32_MAX - 3 ) {
+		std::fill( m_SearchStamps.begin(), m_SearchStamps.end(), 0 );
+		m_SearchStamp		= 0;
+	}
+	m_SearchStamp		+= 2;
+	const uint32_t openStamp		= m_SearchStamp;
+	const uint32_t closedStamp		= m_SearchStamp + 1;
+
+	const int stride					= static_cast<int>( gameState.BoardStride );
+	const int neighbourOffsets[4]		= { -stride, -1, 1, stride };
+	const int goalX						= static_cast<int>( goal % gameState.BoardStride );
+	const int goalY						= static_cast<int>( goal / gameState.BoardStride );
+	auto heuristic						= [&]( uint32_t tile ) {		// Manhattan distance, exact on an empty 4-connected grid.
+		return static_cast<uint32_t>( glm::abs( static_cast<int>( tile % gameState.BoardStride ) - goalX ) + glm::abs( static_cast<int>( tile / gameState.BoardStride ) - goalY ) );
+	};
+	auto isWorseNode					= []( const OpenNode& lhs, const OpenNode& rhs ) {		// Lowest F on top of the heap, on equal F the node furthest along, which reaches the goal with fewer expansions.
+		return lhs.F > rhs.F || ( lhs.F == rhs.F && lhs.G < rhs.G );
+	};
+
+	m_OpenList.clear();
+	m_CostSoFar[start]			= 0;
+	m_CameFrom[start]			= start;
+	m_SearchStamps[start]		= openStamp;
+	m_OpenList.push_back( { heuristic( start ), 0, start } );
+
+	while ( !m_OpenList.empty() ) {
+		std::pop_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+		const OpenNode node		= m_OpenList.back();
+		m_OpenList.pop_back();
+
+		// Skip stale entries, the heap may hold several entries for a tile whose cost was improved.
+		if ( m_SearchStamps[node.Tile] == closedStamp ) {
+			continue;
+		}
+		m_SearchStamps[node.Tile]		= closedStamp;
+		++m_NrOfExpandedNodes;
+
+		if ( node.Tile == goal ) {
+			// Walk back along the path to find the tile right after the start.
+			uint32_t tile		= goal;
+			while ( m_CameFrom[tile] != start ) {
+				tile		= m_CameFrom[tile];
+			}
+			outFirstStep		= tile;
+			return true;
+		}
+
+		for ( int offset : neighbourOffsets ) {
+			const uint32_t neighbour		= static_cast<uint32_t>( static_cast<int>( node.Tile ) + offset );		// The blocked border of the board keeps neighbours inside the buffers.
+			// Tiles are walkable if the snake blocking them has moved away by the time the path gets there. Each tile is only searched at the earliest
+			// arrival found. Snakes can't wait, so a later arrival could find a neighbour free that the earlier one doesn't. Those are ignored on purpose, as a heuristic.
+			const uint32_t costSoFar		= node.G + 1;
+			if ( !gameState.IsTileWalkableAt( neighbour, gameState.Tick + costSoFar ) || m_ReservedStamps[neighbour] == m_ReserveStamp || m_SearchStamps[neighbour] == closedStamp ) {
+				continue;
+			}
+
+			if ( m_SearchStamps[neighbour] == openStamp && m_CostSoFar[neighbour] <= costSoFar ) {
+				continue;
+			}
+			m_SearchStamps[neighbour]		= openStamp;
+			m_CostSoFar[neighbour]			= costSoFar;
+			m_CameFrom[neighbour]			= node.Tile;
+			m_OpenList.push_back( { costSoFar + heuristic( neighbour ), costSoFar, neighbour } );
+			std::push_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+		}
+	}
+	return false;
+}
+
+void AStar::ResizeBuffers( const GameState& gameState ) {
+	if ( m_CostSoFar.size() == gameState.Board.size() ) {
+		return;
+	}
+	m_CostSoFar.assign( gameState.Board.size(), 0 );
+	m_CameFrom.assign( gameState.Board.size(), 0 );
+	m_SearchStamps.assign( gameState.Board.size(), 0 );
+	m_ReservedStamps.assign( gameState.Board.size(), 0 );
+	m_SearchStamp		= 0;
+	m_ReserveStamp		= 1;		// Differs from the cleared stamps, so that FindPath can be used without MakeMoves having reserved anything.
+}
+
+Move AStar::ChooseFallbackMove( const GameState& gameState, uint32_t headTile, Move previousMove ) const {
+	// Keep going the same way if possible, otherwise take the first free direction.
+	const Move moves[5]		= { previousMove, Move::Up, Move::Left, Move::Down, Move::Right };
+	for ( Move move : moves ) {
+		const glm::ivec2 direction		= ConvertMoveToIVec2( move );
+		const uint32_t tile				= static_cast<uint32_t>( static_cast<int>( headTile ) + direction.y * static_cast<int>( gameState.BoardStride ) + direction.x );
+		if ( gameState.IsTileWalkableAt( tile, gameState.Tick + 1 ) && m_ReservedStamps[tile] != m_ReserveStamp ) {
+			return move;
+		}
+	}
+	return previousMove;		// Every direction is blocked.
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Player.h"
+
+// Routes every snake along the shortest path to the apple closest to it, found with A* on the game board.
+// All search memory is owned by the player and sized to the board, and is reset with generation stamps instead of being cleared,
+// so a search does no heap allocation and costs time proportional to the nodes it visits, not to the board size.
+class AStar : public Player {
+public:
+	void			MakeMoves						( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+
+	size_t			GetNrOfExpandedNodes			( ) const;		// Total number of nodes expanded by all searches so far.
+
+					// Finds the shortest path between two board indices, treating tiles that are still blocked when the path reaches them and tiles reserved by team mates as unwalkable.
+					// Returns false if there is no path, otherwise outFirstStep is the board index of the first tile after start along the path.
+	virtual bool	FindPath						( const GameState& gameState, uint32_t start, uint32_t goal, uint32_t& outFirstStep );
+
+protected:
+	struct OpenNode {
+		uint32_t	F;				// Cost so far plus heuristic.
+		uint32_t	G;				// Cost so far.
+		uint32_t	Tile;
+	};
+
+	void			ResizeBuffers					( const GameState& gameState );
+	Move			ChooseFallbackMove				( const GameState& gameState, uint32_t headTile, Move previousMove ) const;
+
+	// Per tile search data, only valid for tiles stamped by the current search.
+	// A tile stamped m_SearchStamp has a cost and came from, one stamped m_SearchStamp + 1 has also been expanded. Anything lower is left over from earlier searches.
+	std::vector<uint32_t>		m_CostSoFar;
+	std::vector<uint32_t>		m_CameFrom;
+	std::vector<uint32_t>		m_SearchStamps;
+	std::vector<uint32_t>		m_ReservedStamps;		// Equal to m_ReserveStamp for tiles that snakes earlier in the team have chosen to move to this tick.
+	uint32_t					m_SearchStamp			= 0;
+	uint32_t					m_ReserveStamp			= 0;
+
+	std::vector<OpenNode>		m_OpenList;				// Binary heap, grows as searches need it and keeps its capacity between them.
+	size_t						m_NrOfExpandedNodes		= 0;
+};
@@ -0,0 +1,385 @@
+#include "AdversarialSearch.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdlib>
+
+static double GetSeconds() {
+	return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+static Move GetMoveTowards( size_t fromTile, size_t toTile ) {
+	const int offset		= static_cast<int>( toTile ) - static_cast<int>( fromTile );
+	return offset == -1 ? Move::Left : offset == 1 ? Move::Right : offset < 0 ? Move::Up : Move::Down;
+}
+
+static size_t GetMoveTarget( const GameState& gameState, size_t headTile, Move move ) {
+	const glm::ivec2 direction		= ConvertMoveToIVec2( move );
+	return static_cast<size_t>( static_cast<int>( headTile ) + direction.y * static_cast<int>( gameState.BoardStride ) + direction.x );
+}
+
+AdversarialSearch::AdversarialSearch( std::unique_ptr<SearchEvaluation> evaluation, Mode mode, double timeBudgetMs, size_t depth )
+	: m_Evaluation( std::move( evaluation ) ), m_Mode( mode ), m_TimeBudgetMs( timeBudgetMs ), m_Depth( std::max<size_t>( depth, 1 ) ) {
+	m_Undos.resize( m_TimeBudgetMs > 0.0 ? SEARCH_MAX_DEPTH : m_Depth );
+}
+
+void AdversarialSearch::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+	const double startSeconds		= GetSeconds();
+	currentState.CopyTo( m_State );		// The only copy of the state per tick, the search moves through the tree in place.
+	m_RootTick						= m_State.Tick;
+	m_TeamMoves.resize( m_State.Teams.size() );
+	m_DecidedMoves.assign( m_State.FreeTickOffsets.size(), Move::Up );
+	m_IsMoveDecided.assign( m_State.FreeTickOffsets.size(), 0 );
+
+	// Each snake gets an even share of the budget, and whatever an earlier snake leaves over goes to the next one.
+	const Team& team		= currentState.Teams[teamIndex];
+	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+		const Snake& snake				= team.Snakes[snakeIndex];
+		const double deadline			= startSeconds + m_TimeBudgetMs / 1000.0 * static_cast<double>( snakeIndex + 1 ) / static_cast<double>( team.Snakes.size() );
+		const Move move					= this->SearchSnake( snake, static_cast<uint32_t>( teamIndex ), deadline );
+		outMoves[snakeIndex]			= move;
+		m_DecidedMoves[snake.Id]		= move;
+		m_IsMoveDecided[snake.Id]		= 1;
+	}
+	m_SearchSeconds		+= GetSeconds() - startSeconds;
+}
+
+size_t AdversarialSearch::GetNrOfNodes() const {
+	return m_NrOfNodes;
+}
+
+double AdversarialSearch::GetSearchSeconds() const {
+	return m_SearchSeconds;
+}
+
+Move AdversarialSearch::SearchSnake( const Snake& snake, uint32_t teamIndex, double deadline ) {
+	m_Deadline			= deadline;
+	m_IsOutOfTime		= false;
+
+	// The closest snakes join the search, except teammates that have chosen their moves already. Ties go to the lowest id, so the players don't depend on the order of the teams.
+	struct Candidate {
+		int						Distance;
+		uint32_t				SnakeId;
+		uint32_t				TeamIndex;
+	};
+	Candidate candidates[SEARCH_MAX_PLAYERS - 1];
+	size_t nrOfCandidates		= 0;
+	const glm::ivec2 head		= snake.Segments.front();
+	for ( size_t otherTeamIndex = 0; otherTeamIndex < m_State.Teams.size(); ++otherTeamIndex ) {
+		for ( const Snake& other : m_State.Teams[otherTeamIndex].Snakes ) {
+			if ( other.Id == snake.Id || m_IsMoveDecided[other.Id] ) {
+				continue;
+			}
+			const glm::ivec2 offset		= other.Segments.front() - head;
+			const Candidate candidate	= { std::abs( offset.x ) + std::abs( offset.y ), other.Id, static_cast<uint32_t>( otherTeamIndex ) };
+			if ( candidate.Distance > SEARCH_PLAYER_RADIUS ) {
+				continue;
+			}
+
+			// Insertion into the short sorted list, dropping the furthest candidate when it is full.
+			size_t slot		= nrOfCandidates;
+			while ( slot > 0 && ( candidates[slot - 1].Distance > candidate.Distance || ( candidates[slot - 1].Distance == candidate.Distance && candidates[slot - 1].SnakeId > candidate.SnakeId ) ) ) {
+				if ( slot < SEARCH_MAX_PLAYERS - 1 ) {
+					candidates[slot]		= candidates[slot - 1];
+				}
+				--slot;
+			}
+			if ( slot < SEARCH_MAX_PLAYERS - 1 ) {
+				candidates[slot]		= candidate;
+				nrOfCandidates			= std::min<size_t>( nrOfCandidates + 1, SEARCH_MAX_PLAYERS - 1 );
+			}
+		}
+	}
+	m_Players.clear();
+	++m_Generation;
+	m_Players.push_back( SearchPlayer{ snake.Id, teamIndex, true, Move::Up } );
+	for ( size_t candidateIndex = 0; candidateIndex < nrOfCandidates; ++candidateIndex ) {
+		m_Players.push_back( SearchPlayer{ candidates[candidateIndex].SnakeId, candidates[candidateIndex].TeamIndex, candidates[candidateIndex].TeamIndex == teamIndex, Move::Up } );
+	}
+
+	// A snake with a single way to go has nothing to search.
+	Move moves[4];
+	Move bestMove		= this->GetPolicyMove( snake );
+	if ( this->GetOrderedMoves( snake, bestMove, moves ) == 1 ) {
+		return moves[0];
+	}
+	bestMove			= moves[0];
+
+	// Each iteration searches one tick deeper, ordered by the entries the iterations before it left in the table. An iteration cut short by the clock is thrown away.
+	const size_t maxDepth		= m_TimeBudgetMs > 0.0 ? SEARCH_MAX_DEPTH : m_Depth;
+	for ( size_t depth = 1; depth <= maxDepth; ++depth ) {
+		Move iterationMove		= bestMove;
+		const float value		= m_Mode == Mode::Paranoid ? this->SearchParanoid( depth, 0, -FLT_MAX, FLT_MAX, &iterationMove ) : this->SearchMaxN( depth, 0, &iterationMove )[0];
+		if ( m_IsOutOfTime ) {
+			break;
+		}
+		// When every move loses, the deeper search can't tell the moves apart any more, so the move of the shallower search stays.
+		if ( value <= SEARCH_DEATH_VALUE / 2 && depth > 1 ) {
+			break;
+		}
+		bestMove				= iterationMove;
+	}
+	return bestMove;
+}
+
+float AdversarialSearch::SearchParanoid( size_t depth, size_t playerIndex, float alpha, float beta, Move* outBestMove ) {
+	++m_NrOfNodes;
+	if ( this->IsOutOfTime() ) {
+		return 0.0f;
+	}
+
+	// Every player has chosen, so everyone moves.
+	if ( playerIndex == m_Players.size() ) {
+		float value;
+		if ( !this->ApplyTick( depth ) || depth == 1 ) {
+			value		= this->EvaluateSnake( m_Players[0].SnakeId, m_Players[0].TeamIndex );
+		} else {
+			// The players choose again in the next tick, while the players of this tick that haven't tried all their moves yet still need the moves chosen before them.
+			Move chosenMoves[SEARCH_MAX_PLAYERS];
+			for ( size_t index = 0; index < m_Players.size(); ++index ) {
+				chosenMoves[index]			= m_Players[index].ChosenMove;
+			}
+			value		= this->SearchParanoid( depth - 1, 0, alpha, beta, nullptr );
+			for ( size_t index = 0; index < m_Players.size(); ++index ) {
+				m_Players[index].ChosenMove	= chosenMoves[index];
+			}
+		}
+		this->UndoTick( depth );
+		return value;
+	}
+
+	SearchPlayer& player		= m_Players[playerIndex];
+	const Snake* snake			= this->FindSnake( player.SnakeId, player.TeamIndex );
+	if ( !snake ) {
+		player.ChosenMove		= Move::Up;		// Keeps the node hashes of the later players independent of what the dead snake chose before.
+		return this->SearchParanoid( depth, playerIndex + 1, alpha, beta, nullptr );
+	}
+
+	// The table gives the move to try first, and ends the search of the node if it has a deep enough value that falls outside the window.
+	const uint64_t nodeHash		= this->GetNodeHash( playerIndex );
+	TranspositionEntry entry{};
+	Move firstMove				= this->GetPolicyMove( *snake );
+	if ( m_Table.Probe( nodeHash, entry ) ) {
+		firstMove				= static_cast<Move>( entry.BestMoves & 3 );
+		if ( entry.Generation == m_Generation && entry.Depth >= depth && !outBestMove ) {
+			if ( entry.Bound == TranspositionBound::Exact ) {
+				return entry.Value;
+			}
+			if ( entry.Bound == TranspositionBound::Lower ) {
+				alpha		= std::max( alpha, entry.Value );
+			} else {
+				beta		= std::min( beta, entry.Value );
+			}
+			if ( alpha >= beta ) {
+				return entry.Value;
+			}
+		}
+	}
+
+	// Allies raise the value of the searched snake, the other teams lower it.
+	Move moves[4];
+	const size_t nrOfMoves		= this->GetOrderedMoves( *snake, firstMove, moves );
+	const float alphaStart		= alpha;
+	const float betaStart		= beta;
+	float bestValue				= player.IsAlly ? -FLT_MAX : FLT_MAX;
+	Move bestMove				= moves[0];
+	for ( size_t moveIndex = 0; moveIndex < nrOfMoves; ++moveIndex ) {
+		player.ChosenMove		= moves[moveIndex];
+		const float value		= this->SearchParanoid( depth, playerIndex + 1, alpha, beta, nullptr );
+		if ( m_IsOutOfTime ) {
+			return 0.0f;
+		}
+		if ( player.IsAlly ? value > bestValue : value < bestValue ) {
+			bestValue			= value;
+			bestMove			= moves[moveIndex];
+		}
+		if ( player.IsAlly ) {
+			alpha				= std::max( alpha, value );
+		} else {
+			beta				= std::min( beta, value );
+		}
+		if ( alpha >= beta ) {
+			break;
+		}
+	}
+
+	entry.Value			= bestValue;
+	entry.BestMoves		= static_cast<uint8_t>( bestMove );
+	entry.Depth			= static_cast<uint8_t>( depth );
+	entry.Bound			= bestValue <= alphaStart ? TranspositionBound::Upper : bestValue >= betaStart ? TranspositionBound::Lower : TranspositionBound::Exact;
+	entry.Generation	= m_Generation;
+	m_Table.Store( nodeHash, entry );
+	if ( outBestMove ) {
+		*outBestMove		= bestMove;
+	}
+	return bestValue;
+}
+
+AdversarialSearch::Values AdversarialSearch::SearchMaxN( size_t depth, size_t playerIndex, Move* outBestMove ) {
+	++m_NrOfNodes;
+	if ( this->IsOutOfTime() ) {
+		return Values();
+	}
+
+	if ( playerIndex == m_Players.size() ) {
+		Values values;
+		if ( !this->ApplyTick( depth ) || depth == 1 ) {
+			values		= this->EvaluatePlayers();
+		} else {
+			// The players choose again in the next tick, while the players of this tick that haven't tried all their moves yet still need the moves chosen before them.
+			Move chosenMoves[SEARCH_MAX_PLAYERS];
+			for ( size_t index = 0; index < m_Players.size(); ++index ) {
+				chosenMoves[index]			= m_Players[index].ChosenMove;
+			}
+			values		= this->SearchMaxN( depth - 1, 0, nullptr );
+			for ( size_t index = 0; index < m_Players.size(); ++index ) {
+				m_Players[index].ChosenMove	= chosenMoves[index];
+			}
+		}
+		this->UndoTick( depth );
+		return values;
+	}
+
+	SearchPlayer& player		= m_Players[playerIndex];
+	const Snake* snake			= this->FindSnake( player.SnakeId, player.TeamIndex );
+	if ( !snake ) {
+		player.ChosenMove		= Move::Up;
+		return this->SearchMaxN( depth, playerIndex + 1, nullptr );
+	}
+
+	// Values of several players don't fit in the table, so it only orders the moves.
+	const uint64_t nodeHash		= this->GetNodeHash( playerIndex );
+	TranspositionEntry entry{};
+	Move firstMove				= this->GetPolicyMove( *snake );
+	if ( m_Table.Probe( nodeHash, entry ) ) {
+		firstMove				= static_cast<Move>( entry.BestMoves & 3 );
+	}
+
+	// Every player takes the move that is best for itself.
+	Move moves[4];
+	const size_t nrOfMoves		= this->GetOrderedMoves( *snake, firstMove, moves );
+	Values bestValues;
+	Move bestMove				= moves[0];
+	for ( size_t moveIndex = 0; moveIndex < nrOfMoves; ++moveIndex ) {
+		player.ChosenMove		= moves[moveIndex];
+		const Values values		= this->SearchMaxN( depth, playerIndex + 1, nullptr );
+		if ( m_IsOutOfTime ) {
+			return Values();
+		}
+		if ( moveIndex == 0 || values[playerIndex] > bestValues[playerIndex] ) {
+			bestValues			= values;
+			bestMove			= moves[moveIndex];
+		}
+	}
+
+	entry.Value			= bestValues[playerIndex];
+	entry.BestMoves		= static_cast<uint8_t>( bestMove );
+	entry.Depth			= static_cast<uint8_t>( depth );
+	entry.Bound			= TranspositionBound::Exact;
+	entry.Generation	= m_Generation;
+	m_Table.Store( nodeHash, entry );
+	if ( outBestMove ) {
+		*outBestMove		= bestMove;
+	}
+	return bestValues;
+}
+
+bool AdversarialSearch::ApplyTick( size_t depth ) {
+	// Players make their chosen moves, teammates searched before keep the moves they chose for this tick, and everyone else follows the policy.
+	for ( size_t teamIndex = 0; teamIndex < m_State.Teams.size(); ++teamIndex ) {
+		const Team& team			= m_State.Teams[teamIndex];
+		std::vector<Move>& moves	= m_TeamMoves[teamIndex];
+		moves.resize( team.Snakes.size() );
+		for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+			const Snake& snake		= team.Snakes[snakeIndex];
+			auto player				= std::find_if( m_Players.begin(), m_Players.end(), [&snake]( const SearchPlayer& p ) { return p.SnakeId == snake.Id; } );
+			if ( player != m_Players.end() ) {
+				moves[snakeIndex]		= player->ChosenMove;
+			} else if ( m_State.Tick == m_RootTick && m_IsMoveDecided[snake.Id] ) {
+				moves[snakeIndex]		= m_DecidedMoves[snake.Id];
+			} else {
+				moves[snakeIndex]		= this->GetPolicyMove( snake );
+			}
+		}
+	}
+	Game::ApplyMoves( m_State, m_TeamMoves, nullptr, &m_Undos[depth - 1] );
+	return this->FindSnake( m_Players[0].SnakeId, m_Players[0].TeamIndex ) != nullptr;
+}
+
+void AdversarialSearch::UndoTick( size_t depth ) {
+	Game::UndoMoves( m_State, m_Undos[depth - 1] );
+}
+
+AdversarialSearch::Values AdversarialSearch::EvaluatePlayers() {
+	Values values;
+	values.fill( 0.0f );
+	for ( size_t playerIndex = 0; playerIndex < m_Players.size(); ++playerIndex ) {
+		values[playerIndex]		= this->EvaluateSnake( m_Players[playerIndex].SnakeId, m_Players[playerIndex].TeamIndex );
+	}
+	return values;
+}
+
+float AdversarialSearch::EvaluateSnake( uint32_t snakeId, uint32_t teamIndex ) {
+	const Snake* snake		= this->FindSnake( snakeId, teamIndex );
+	if ( !snake ) {
+		return SEARCH_DEATH_VALUE + static_cast<float>( m_State.Tick );
+	}
+	return m_Evaluation->Evaluate( m_State, *snake ) + SEARCH_LENGTH_WEIGHT * static_cast<float>( snake->Segments.size() + snake->SegmentsToSpawn );
+}
+
+size_t AdversarialSearch::GetOrderedMoves( const Snake& snake, Move firstMove, Move* outMoves ) const {
+	const size_t headTile		= m_State.GetTileIndex( snake.Segments.front() );
+	size_t nrOfMoves			= 0;
+	for ( int moveIndex = 0; moveIndex < 4; ++moveIndex ) {
+		const Move move			= static_cast<Move>( ( static_cast<int>( firstMove ) + moveIndex ) % 4 );
+		if ( m_State.IsTileWalkableAt( GetMoveTarget( m_State, headTile, move ), m_State.Tick + 1 ) ) {
+			outMoves[nrOfMoves++]		= move;
+		}
+	}
+	if ( nrOfMoves == 0 ) {		// Every move is deadly, so which one doesn't matter.
+		outMoves[nrOfMoves++]		= firstMove;
+	}
+	return nrOfMoves;
+}
+
+Move AdversarialSearch::GetPolicyMove( const Snake& snake ) const {
+	// Follow the apple flow field while it leads onto a free tile, otherwise take any free tile.
+	const size_t headTile		= m_State.GetTileIndex( snake.Segments.front() );
+	const uint32_t nextTile		= m_State.AppleFlow.GetNextTile( headTile );
+	if ( nextTile != NO_FLOW && nextTile != headTile && m_State.IsTileWalkableAt( nextTile, m_State.Tick + 1 ) ) {
+		return GetMoveTowards( headTile, nextTile );
+	}
+	for ( int moveIndex = 0; moveIndex < 4; ++moveIndex ) {
+		if ( m_State.IsTileWalkableAt( GetMoveTarget( m_State, headTile, static_cast<Move>( moveIndex ) ), m_State.Tick + 1 ) ) {
+			return static_cast<Move>( moveIndex );
+		}
+	}
+	return Move::Up;
+}
+
+const Snake* AdversarialSearch::FindSnake( uint32_t snakeId, uint32_t teamIndex ) const {
+	for ( const Snake& snake : m_State.Teams[teamIndex].Snakes ) {
+		if ( snake.Id == snakeId ) {
+			return &snake;
+		}
+	}
+	return nullptr;
+}
+
+uint64_t AdversarialSearch::GetNodeHash( size_t playerIndex ) const {
+	// Players choose one after another without changing the state, so the moves chosen so far tell the nodes of a tick apart. The searched snake
+	// keeps the searches of different snakes apart, since they value states differently.
+	uint64_t chosenMoves		= 0;
+	for ( size_t earlierIndex = 0; earlierIndex < playerIndex; ++earlierIndex ) {
+		chosenMoves				|= static_cast<uint64_t>( m_Players[earlierIndex].ChosenMove ) << ( 2 * earlierIndex );
+	}
+	return m_State.Hash ^ ZobristKey( ZobristFeature::SearchNode, m_Players[0].SnakeId * SEARCH_MAX_PLAYERS + playerIndex, chosenMoves );
+}
+
+bool AdversarialSearch::IsOutOfTime() {
+	if ( !m_IsOutOfTime && m_TimeBudgetMs > 0.0 ) {		// Reading the steady clock costs far less than a node, whose evaluation walks the board.
+		m_IsOutOfTime		= GetSeconds() >= m_Deadline;
+	}
+	return m_IsOutOfTime;
+}
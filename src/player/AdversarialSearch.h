@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include "Player.h"
+#include "SearchEvaluation.h"
+#include "../Game.h"
+#include "../TranspositionTable.h"
+
+#define SEARCH_MAX_PLAYERS			3			// The snake searched for and the closest other snakes, whose moves are searched too. The rest follow a fixed policy.
+#define SEARCH_PLAYER_RADIUS		6			// Manhattan distance between heads within which another snake takes part in the search.
+#define SEARCH_DEFAULT_DEPTH		2			// Ticks searched per snake without a time budget.
+#define SEARCH_MAX_DEPTH			32			// Deepest iteration with a time budget.
+#define SEARCH_LENGTH_WEIGHT		16.0f		// Added to the evaluation per segment of the snake, including segments still to spawn.
+#define SEARCH_DEATH_VALUE			-1.0e6f		// Value of a dead snake, plus the tick it died in so that dying later is better.
+
+// Searches the game tree of each snake of the team, with the closest snakes of any team taking part as further players. Each tick of the tree is one ply per player,
+// every player choosing a move before they all move at once with Game::ApplyMoves. Paranoid search assumes that the snakes of other teams play against the searched snake
+// and cuts branches with alpha beta. Max-n lets every snake maximize its own evaluation. The state is walked with ApplyMoves and UndoMoves instead of copied per node.
+// Iterative deepening fills a transposition table that orders the moves of the next iteration. The entries outlive the tick, so the search of the next tick starts with
+// the best moves found for the states it already saw. Their values only cut branches within the search that stored them, since other searches have other players. Without a time budget every snake is searched to a fixed depth, which keeps games reproducible from their seed.
+// With one, the deepest finished iteration gives the move when the budget of the snake runs out.
+class AdversarialSearch : public Player {
+public:
+	enum class Mode {
+		Paranoid,
+		MaxN
+	};
+
+								// A time budget of zero searches every snake to the given depth. Otherwise the budget is shared by the snakes of the team.
+								AdversarialSearch				( std::unique_ptr<SearchEvaluation> evaluation, Mode mode = Mode::Paranoid, double timeBudgetMs = 0.0, size_t depth = SEARCH_DEFAULT_DEPTH );
+	void						MakeMoves						( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+
+	size_t						GetNrOfNodes					( ) const override;
+	double						GetSearchSeconds				( ) const override;
+
+private:
+	using Values		= std::array<float, SEARCH_MAX_PLAYERS>;		// Value of the state for each player, only the first one is used by paranoid search.
+
+	struct SearchPlayer {
+		uint32_t				SnakeId;
+		uint32_t				TeamIndex;
+		bool					IsAlly;				// On the team of the searched snake, so it maximizes its value in paranoid search too.
+		Move					ChosenMove;			// Move of the player in the tick being searched.
+	};
+
+	Move						SearchSnake						( const Snake& snake, uint32_t teamIndex, double deadline );
+	float						SearchParanoid					( size_t depth, size_t playerIndex, float alpha, float beta, Move* outBestMove );
+	Values						SearchMaxN						( size_t depth, size_t playerIndex, Move* outBestMove );
+	bool						ApplyTick						( size_t depth );		// Moves every snake. Returns false if the searched snake died.
+	void						UndoTick						( size_t depth );
+	Values						EvaluatePlayers					( );
+	float						EvaluateSnake					( uint32_t snakeId, uint32_t teamIndex );
+
+	size_t						GetOrderedMoves					( const Snake& snake, Move firstMove, Move* outMoves ) const;		// Moves onto free tiles, firstMove first. Returns how many.
+	Move						GetPolicyMove					( const Snake& snake ) const;		// Move of the snakes that aren't searched.
+	const Snake*				FindSnake						( uint32_t snakeId, uint32_t teamIndex ) const;		// Null if the snake is dead.
+	uint64_t					GetNodeHash						( size_t playerIndex ) const;
+	bool						IsOutOfTime						( );
+
+	std::unique_ptr<SearchEvaluation>	m_Evaluation;
+	Mode						m_Mode;
+	double						m_TimeBudgetMs;
+	size_t						m_Depth;
+	TranspositionTable			m_Table;
+	GameState					m_State;				// Copy of the current state, walked through by the search.
+	std::vector<MoveUndo>		m_Undos;				// One per tick of depth.
+	std::vector<std::vector<Move>>	m_TeamMoves;		// Moves of every snake in the tick being applied.
+	std::vector<SearchPlayer>	m_Players;				// The searched snake first.
+	std::vector<Move>			m_DecidedMoves;			// Per snake id, the moves chosen this tick for snakes of the team that were searched already.
+	std::vector<uint8_t>		m_IsMoveDecided;		// Per snake id.
+	uint32_t					m_RootTick				= 0;
+	uint8_t						m_Generation			= 0;		// Counts the searches, stored with the table entries.
+	double						m_Deadline				= 0.0;		// Time the search of the current snake stops at, in seconds on the steady clock.
+	bool						m_IsOutOfTime			= false;
+	size_t						m_NrOfNodes				= 0;
+	double						m_SearchSeconds			= 0.0;
+};
@@ -1,5 +1,7 @@
 #include "Boids.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <glm/geometric.hpp>
 
 #define RULE_FACTOR_COHESION			0.7f
@@ -12,16 +14,12 @@
 #define TEAM_AVOIDANCE_DISTANCE			4.0f		// Detection distance for seperating snakes from snakes in the same team.
 #define LOCAL_GOAL_DISTANCE				4.0f		// Detection distance for individual snakes grabbing nearby apples.
 
-Move ChooseSafeMove( const glm::vec2& direction, Move previousMove, const std::vector<Move>& safeMoves );
+static_assert( AVOIDANCE_DISTANCE <= BOARD_PADDING, "Seperation scan would read outside of the board's blocked border." );
 
-void Boids::MakeMoves( const GameState currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+Move ChooseSafeMove( const glm::vec2& direction, Move previousMove, const std::vector<Move>& safeMoves, Random& random );
+
+void Boids::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
 	const Team& team						= currentState.Teams[teamIndex];
-	const glm::vec2 teamAvaragePosition		= CalculateAvaragePosition( currentState, teamIndex );
-	
-	// Choose a new apple for the team as its goal if the previous goal-apple was taken.
-	if ( !currentState.IsTileWalkable( m_GoalTile ) || currentState.Board[m_GoalTile.y][m_GoalTile.x] != Tile::Apple ) {
-		m_GoalTile		= currentState.FindClosestApple( teamAvaragePosition );		// TODO: Figure out another goal if there are no apples.
-	}
 
 	// Decide for each snake which direction it should move.
 	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
@@ -29,21 +27,44 @@ void Boids::MakeMoves( const GameState currentState, size_t teamIndex, std::vect
 		const glm::ivec2& snakeTile				= snake.Segments[0];
 		const glm::vec2 snakePosition			= glm::vec2( snakeTile );
 
-		// Calculate which moves the snake can make without dying this turn.		// TODO: Take into account that tails move.
+		// Calculate which moves the snake can make without dying this turn. Blocked tiles are safe too if they are the tail of a snake that moves away this turn.
+		const size_t snakeTileIndex				= currentState.GetTileIndex( snakeTile );
+		const uint64_t blockedRow				= currentState.GetBlockedBits( snakeTileIndex - 1, 3 );		// Bit 0 is the tile to the left, bit 2 the tile to the right.
+		const size_t arrivalTick				= currentState.Tick + 1;
 		std::vector<Move> safeMoves;
-		if ( currentState.IsTileWalkable( snakeTile + glm::ivec2( 0, -1 ) ) ) {
+		if ( !currentState.IsTileBlockedBit( snakeTileIndex - currentState.BoardStride ) || currentState.IsTileWalkableAt( snakeTileIndex - currentState.BoardStride, arrivalTick ) ) {
 			safeMoves.push_back( Move::Up );
 		}
-		if ( currentState.IsTileWalkable( snakeTile + glm::ivec2( 0, 1 ) ) ) {
+		if ( !currentState.IsTileBlockedBit( snakeTileIndex + currentState.BoardStride ) || currentState.IsTileWalkableAt( snakeTileIndex + currentState.BoardStride, arrivalTick ) ) {
 			safeMoves.push_back( Move::Down );
 		}
-		if ( currentState.IsTileWalkable( snakeTile + glm::ivec2( -1, 0 ) ) ) {
+		if ( !( blockedRow & 1 ) || currentState.IsTileWalkableAt( snakeTileIndex - 1, arrivalTick ) ) {
 			safeMoves.push_back( Move::Left );
 		}
-		if ( currentState.IsTileWalkable( snakeTile + glm::ivec2( 1, 0 ) ) ) {
+		if ( !( blockedRow & 4 ) || currentState.IsTileWalkableAt( snakeTileIndex + 1, arrivalTick ) ) {
 			safeMoves.push_back( Move::Right );
 		}
 
+		// Drop the safe moves that lead into a pocket with less room than the others. Counting stops once there is room for the whole snake.
+		if ( safeMoves.size() > 1 ) {
+			const size_t neededArea			= snake.Segments.size() + snake.SegmentsToSpawn;
+			size_t areas[4];
+			size_t largestArea				= 0;
+			for ( size_t moveIndex = 0; moveIndex < safeMoves.size(); ++moveIndex ) {
+				const glm::ivec2 direction		= ConvertMoveToIVec2( safeMoves[moveIndex] );
+				const size_t tileIndex			= snakeTileIndex + direction.y * currentState.BoardStride + direction.x;
+				areas[moveIndex]				= m_ReachableArea.CountTailAware( currentState, tileIndex, static_cast<uint32_t>( arrivalTick ), neededArea );
+				largestArea						= std::max( largestArea, areas[moveIndex] );
+			}
+			size_t nrOfRoomyMoves			= 0;
+			for ( size_t moveIndex = 0; moveIndex < safeMoves.size(); ++moveIndex ) {
+				if ( areas[moveIndex] == largestArea ) {
+					safeMoves[nrOfRoomyMoves++]		= safeMoves[moveIndex];
+				}
+			}
+			safeMoves.resize( nrOfRoomyMoves );
+		}
+
 		// If there is only one safe move it is chosen, and we continue to the next snake instead.
 		if ( safeMoves.size() == 1 ) {
 			outMoves[snakeIndex]		= safeMoves.front();
@@ -61,19 +82,10 @@ void Boids::MakeMoves( const GameState currentState, size_t teamIndex, std::vect
 			newSnakeDirection				+= RULE_FACTOR_TEAM_SEPERATION		* TeamSeperationDirection( currentState, teamIndex, snakeIndex );
 		}
 
-		outMoves[snakeIndex]		= ChooseSafeMove( newSnakeDirection, outMoves[snakeIndex], safeMoves );
+		outMoves[snakeIndex]		= ChooseSafeMove( newSnakeDirection, outMoves[snakeIndex], safeMoves, m_Random );
 	}
 }
 
-glm::vec2 Boids::CalculateAvaragePosition( const GameState & gameState, const size_t teamIndex ) const {
-	const Team& team					= gameState.Teams[teamIndex];
-	glm::ivec2 summedTeamPosition		= glm::ivec2( 0 );
-	for ( const auto& snake : team.Snakes ) {
-		summedTeamPosition		+= snake.Segments[0];
-	}
-	return glm::vec2( summedTeamPosition ) / static_cast<float>(team.Snakes.size());
-}
-
 glm::vec2 Boids::CohesionDirection( const GameState & gameState, const size_t teamIndex, const size_t snakeIndex ) const {
 	const Team& team					= gameState.Teams[teamIndex];
 	const Snake& snake					= team.Snakes[snakeIndex];
@@ -124,30 +136,23 @@ glm::vec2 Boids::AlignmentDirection( const GameState & gameState, const size_t t
 }
 
 glm::vec2 Boids::GoalDirection( const GameState & gameState, const size_t teamIndex, const size_t snakeIndex ) const {
-	const Team& team				= gameState.Teams[teamIndex];
-	const Snake& snake				= team.Snakes[snakeIndex];
-	const glm::ivec2& snakeTile		= snake.Segments[0];
-	if ( m_GoalTile != snakeTile ) {
-		return glm::normalize( glm::vec2( m_GoalTile - snakeTile ) );	// Calculate normalized direction towards goal.
+	// Calculate the direction of the first move on the way to the closest apple, read from the flow field shared by all snakes.
+	const size_t snakeTileIndex		= gameState.GetTileIndex( gameState.Teams[teamIndex].Snakes[snakeIndex].Segments[0] );
+	const uint32_t nextTileIndex	= gameState.AppleFlow.GetNextTile( snakeTileIndex );
+	if ( nextTileIndex == NO_FLOW || nextTileIndex == snakeTileIndex ) {
+		return glm::vec2( 0.0f );		// No apple can be reached.
 	}
-	return glm::vec2( 0.0f );
+	const int offset				= static_cast<int>( nextTileIndex ) - static_cast<int>( snakeTileIndex );
+	const int stride				= static_cast<int>( gameState.BoardStride );
+	return offset == -1 ? glm::vec2( -1.0f, 0.0f ) : offset == 1 ? glm::vec2( 1.0f, 0.0f ) : offset == -stride ? glm::vec2( 0.0f, -1.0f ) : glm::vec2( 0.0f, 1.0f );
 }
 
 glm::vec2 Boids::LocalGoalDirection( const GameState& gameState, const size_t teamIndex, const size_t snakeIndex ) const {
-	const Team& team					= gameState.Teams[teamIndex];
-	const Snake& snake					= team.Snakes[snakeIndex];
-	const glm::vec2& snakePosition		= snake.Segments[0];
-
-	// Find and calculate distance to closest apple.
-	const glm::ivec2 closestApple				= gameState.FindClosestApple( snakePosition );
-	const glm::vec2 vectorToClosestApple		= glm::vec2( closestApple ) - snakePosition;
-	const float distanceToClosestAppleSqrd		= glm::dot( vectorToClosestApple, vectorToClosestApple );
-
-	// Return direction to closest apple if it is within detection distance.
-	if ( distanceToClosestAppleSqrd <= LOCAL_GOAL_DISTANCE * LOCAL_GOAL_DISTANCE ) {
-		if ( distanceToClosestAppleSqrd != 0.0f ) {
-			return vectorToClosestApple / distanceToClosestAppleSqrd;		// Direction to the local goal (closest apple), diminishes with distance.
-		}
+	// Pull harder towards the goal the closer the apple is, but only once it is within detection distance.
+	const size_t snakeTileIndex		= gameState.GetTileIndex( gameState.Teams[teamIndex].Snakes[snakeIndex].Segments[0] );
+	const uint32_t distance			= gameState.AppleFlow.GetDistance( snakeTileIndex );
+	if ( distance != 0 && static_cast<float>( distance ) <= LOCAL_GOAL_DISTANCE ) {
+		return GoalDirection( gameState, teamIndex, snakeIndex ) / static_cast<float>( distance );		// Diminishes with distance.
 	}
 	return glm::vec2( 0.0f );	// Apple not found (or on the same tile as the snake for some reason).
 }
@@ -156,18 +161,19 @@ glm::vec2 Boids::SeperationDirection( const GameState& gameState, const size_t t
 	const Team& team				= gameState.Teams[teamIndex];
 	const Snake& snake				= team.Snakes[snakeIndex];
 	const glm::ivec2& snakeTile		= snake.Segments[0];
+	const size_t snakeTileIndex		= gameState.GetTileIndex( snakeTile );
 
 	// Accumulate repelling forces that keeps the snake away from blocked tiles within the avoidance distance.
 	glm::vec2 avoidDirection		= glm::vec2( 0.0f );
 	for ( int dy = -AVOIDANCE_DISTANCE; dy <= AVOIDANCE_DISTANCE; ++dy ) {
-		for ( int dx = -AVOIDANCE_DISTANCE; dx <= AVOIDANCE_DISTANCE; ++dx ) {
+		// Only the blocked tiles of the row are visited, walkable tiles are safe for the snake to traverse.
+		const size_t rowIndex		= snakeTileIndex + dy * gameState.BoardStride;
+		uint64_t blockedRow			= gameState.GetBlockedBits( rowIndex - AVOIDANCE_DISTANCE, 2 * AVOIDANCE_DISTANCE + 1 );
+		while ( blockedRow != 0 ) {
+			const int dx				= CountTrailingZeros( blockedRow ) - AVOIDANCE_DISTANCE;
+			blockedRow					&= blockedRow - 1;		// Clear the lowest set bit.
 			const glm::ivec2 tile		= glm::ivec2( snakeTile.x + dx, snakeTile.y + dy );
 
-			// Tiles that are walkable are skipped, since they are safe for the snake to traverse.
-			if ( gameState.IsTileWalkable( tile ) ) {		// TODO: Take into account that tails move.
-				continue;
-			}
-
 			// Skip tile if it is one of the 4 first segments in the snake, since the head cannot collide with any of those segments.
 			bool skipTile = false;
 			for ( size_t segmentIndex = 0; segmentIndex < 4 && segmentIndex < snake.Segments.size(); ++segmentIndex ) {
@@ -180,10 +186,16 @@ glm::vec2 Boids::SeperationDirection( const GameState& gameState, const size_t t
 				continue;
 			}
 
+			// Skip tile if it is the tail of a snake that will have moved away before the head can get there.
+			const size_t arrivalTick			= gameState.Tick + std::abs( dx ) + std::abs( dy );
+			if ( gameState.IsTileWalkableAt( rowIndex + dx, arrivalTick ) ) {
+				continue;
+			}
+
 			// Add repelling force that keeps the snake away from the tile
 			const glm::vec2 vectorFromTile		= glm::vec2( snakeTile - tile );
 			const float distanceFromTile		= glm::length( vectorFromTile );
-			avoidDirection 						+= vectorFromTile / ( glm::pow( distanceFromTile, 3 ) );		// Force diminishes with distance.
+			avoidDirection 						+= vectorFromTile / ( glm::pow( distanceFromTile, 3.0f ) );		// Force diminishes with distance.
 		}
 	}
 	return avoidDirection;
@@ -207,19 +219,19 @@ glm::vec2 Boids::TeamSeperationDirection( const GameState& gameState, const size
 
 		// Add repelling force from this snake if within the avoidance distance.
 		if ( distanceFromTeamMate <= TEAM_AVOIDANCE_DISTANCE ) {
-			avoidDirection		+= vectorFromTeamMate / ( glm::pow( distanceFromTeamMate, 3 ) );		// Calculate force from the individual snake, quickly diminishes with distance.
+			avoidDirection		+= vectorFromTeamMate / ( glm::pow( distanceFromTeamMate, 3.0f ) );		// Calculate force from the individual snake, quickly diminishes with distance.
 		}
 	}
 	return avoidDirection;		// Direction intentially not normalized so that effect varies depending on how close team-mates are.
 }
 
-Move ChooseSafeMove( const glm::vec2& direction, Move previousMove, const std::vector<Move>& safeMoves ) {
+Move ChooseSafeMove( const glm::vec2& direction, Move previousMove, const std::vector<Move>& safeMoves, Random& random ) {
 	// Choose a random move (preferably safe) if no direction is specified.
 	if ( direction == glm::vec2( 0.0f ) ) {
 		if ( safeMoves.empty() ) {
 			return static_cast<Move>( static_cast<int>(previousMove) + 1 % 4 );
 		} else {
-			return safeMoves[ rand() % safeMoves.size() ];
+			return safeMoves[ random.NextBelow( static_cast<uint32_t>( safeMoves.size() ) ) ];
 		}
 	}
 
@@ -230,14 +242,14 @@ Move ChooseSafeMove( const glm::vec2& direction, Move previousMove, const std::v
 				return Move::Right;
 			} else {
 				const glm::vec2 modifiedDirection		= glm::vec2( 0.0f, direction.y );
-				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves );
+				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves, random );
 			}
 		} else {		// Direction is mostly left.
 			if ( std::find( safeMoves.cbegin(), safeMoves.cend(), Move::Left ) != safeMoves.cend() ) {
 				return Move::Left;
 			} else {
 				const glm::vec2 modifiedDirection		= glm::vec2( 0.0f, direction.y );
-				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves );
+				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves, random );
 			}
 		}
 	} else {		// Direction is mostly down.
@@ -246,14 +258,14 @@ Move ChooseSafeMove( const glm::vec2& direction, Move previousMove, const std::v
 				return Move::Down;
 			} else {
 				const glm::vec2 modifiedDirection		= glm::vec2( direction.x, 0.0f );
-				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves );
+				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves, random );
 			}
 		} else {		// Direction is mostly up.
 			if ( std::find( safeMoves.cbegin(), safeMoves.cend(), Move::Up ) != safeMoves.cend() ) {
 				return Move::Up;
 			} else {
 				const glm::vec2 modifiedDirection		= glm::vec2( direction.x, 0.0f );
-				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves );
+				return ChooseSafeMove( modifiedDirection, previousMove, safeMoves, random );
 			}
 		}
 	}
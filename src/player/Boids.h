@@ -1,13 +1,15 @@
 #pragma once
 
 #include "Player.h"
+#include "../Random.h"
+#include "../ReachableArea.h"
 
 class Boids : public Player {
 public:
-	void			MakeMoves						( const GameState currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+	explicit		Boids							( uint64_t seed ) : m_Random( seed ) { }
+	void			MakeMoves						( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
 
 private:
-	glm::vec2		CalculateAvaragePosition		( const GameState& gameState, const size_t teamIndex ) const;
 	glm::vec2		CohesionDirection				( const GameState& gameState, const size_t teamIndex, const size_t snakeIndex ) const;
 	glm::vec2		AlignmentDirection				( const GameState& gameState, const size_t teamIndex, const size_t snakeIndex ) const;
 	glm::vec2		GoalDirection					( const GameState& gameState, const size_t teamIndex, const size_t snakeIndex ) const;
@@ -15,5 +17,6 @@ private:
 	glm::vec2		SeperationDirection				( const GameState& gameState, const size_t teamIndex, const size_t snakeIndex ) const;
 	glm::vec2		TeamSeperationDirection			( const GameState& gameState, const size_t teamIndex, const size_t snakeIndex ) const;
 
-	glm::ivec2		m_GoalTile						= glm::ivec2( -1 );		// Position chosen so that goal gets recalculated first time moves are calculated.
+	Random			m_Random;												// Picks between safe moves when there is no preferred direction.
+	ReachableArea	m_ReachableArea;										// Measures the room behind each safe move.
 };
\ No newline at end of file
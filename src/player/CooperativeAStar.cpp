@@ -0,0 +1,243 @@
+#include "CooperativeAStar.h"
+
+#include <algorithm>
+
+// Most nodes a search can create, one per depth for each tile within that many steps of the head. There are 2d^2 + 2d + 1 of those at depth d.
+static constexpr size_t GetMaxNrOfNodes() {
+	size_t nrOfNodes		= 0;
+	for ( size_t depth = 0; depth <= COOPERATIVE_WINDOW; ++depth ) {
+		nrOfNodes				+= 2 * depth * depth + 2 * depth + 1;
+	}
+	return nrOfNodes;
+}
+
+static_assert( COOPERATIVE_VISIT_SLOTS >= 2 * GetMaxNrOfNodes() && ( COOPERATIVE_VISIT_SLOTS & ( COOPERATIVE_VISIT_SLOTS - 1 ) ) == 0, "The visit table must be a power of two with room for every node." );
+static_assert( ( COOPERATIVE_MIN_RESERVATION_SLOTS & ( COOPERATIVE_MIN_RESERVATION_SLOTS - 1 ) ) == 0, "The reservation table must be a power of two." );
+
+// First slot to probe for a tile at a tick or depth, in a table with a power of two number of slots.
+static inline size_t GetSlot( uint32_t tile, uint32_t tick, size_t nrOfSlots ) {
+	return static_cast<size_t>( ( ( ( uint64_t( tick ) << 32 ) | tile ) * 0x9E3779B97F4A7C15ull ) >> 32 ) & ( nrOfSlots - 1 );
+}
+
+void CooperativeAStar::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+	const Team& team		= currentState.Teams[teamIndex];
+	this->ResizeBuffers( team );
+
+	// The reservations of snakes that are not on the team anymore are stale.
+	for ( const Snake& snake : team.Snakes ) {
+		m_SnakePlans[snake.Id].AliveTick		= currentState.Tick;
+	}
+
+	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+		const Snake& snake			= team.Snakes[snakeIndex];
+		const uint32_t headTile		= static_cast<uint32_t>( currentState.GetTileIndex( snake.Segments[0] ) );
+		const uint32_t nextTile		= this->PlanSnake( currentState, snake, snake.Segments.size() + snake.SegmentsToSpawn );
+
+		// Keep the previous move if the snake has nowhere to go.
+		if ( nextTile != headTile ) {
+			const int offset		= static_cast<int>( nextTile ) - static_cast<int>( headTile );
+			outMoves[snakeIndex]	= offset == -1 ? Move::Left : offset == 1 ? Move::Right : offset < 0 ? Move::Up : Move::Down;
+		}
+	}
+}
+
+size_t CooperativeAStar::GetNrOfExpandedNodes() const {
+	return m_NrOfExpandedNodes;
+}
+
+void CooperativeAStar::ResizeBuffers( const Team& team ) {
+	if ( m_Visits.empty() ) {
+		m_Visits.assign( COOPERATIVE_VISIT_SLOTS, { 0, 0, 0 } );
+		m_Reservations.assign( COOPERATIVE_MIN_RESERVATION_SLOTS, { 0, 0, NO_SNAKE, 0 } );
+		m_Nodes.reserve( GetMaxNrOfNodes() );
+		m_OpenList.reserve( GetMaxNrOfNodes() );		// Every node is pushed once.
+	}
+	for ( const Snake& snake : team.Snakes ) {
+		if ( snake.Id >= m_SnakePlans.size() ) {
+			m_SnakePlans.resize( snake.Id + 1 );
+		}
+	}
+}
+
+uint32_t CooperativeAStar::PlanSnake( const GameState& gameState, const Snake& snake, size_t snakeLength ) {
+	// Start a new search. When the stamp wraps around, old stamps could be mistaken for new ones, so they are cleared.
+	if ( ++m_SearchStamp == 0 ) {
+		std::fill( m_Visits.begin(), m_Visits.end(), Visit{ 0, 0, 0 } );
+		m_SearchStamp		= 1;
+	}
+
+	// The plan the snake made on the tick before is replaced, so it stops blocking the search.
+	const uint32_t tick						= gameState.Tick;
+	m_SnakePlans[snake.Id].PlanTick			= tick;
+
+	const size_t boardSize				= gameState.Board.size();
+	const int stride					= static_cast<int>( gameState.BoardStride );
+	const int neighbourOffsets[4]		= { -stride, -1, 1, stride };
+	auto estimate						= [&]( uint32_t tile ) {		// Distance to the closest apple, or the longest possible distance if no apple can be reached from the tile.
+		return std::min( gameState.AppleFlow.GetDistance( tile ), static_cast<uint32_t>( boardSize ) );
+	};
+	auto isWorseNode					= [this]( const OpenNode& lhs, const OpenNode& rhs ) {		// Lowest F on top of the heap, on equal F the deepest node.
+		return lhs.F > rhs.F || ( lhs.F == rhs.F && m_Nodes[lhs.Node].Depth < m_Nodes[rhs.Node].Depth );
+	};
+
+	const uint32_t headTile		= static_cast<uint32_t>( gameState.GetTileIndex( snake.Segments[0] ) );
+	m_Nodes.clear();
+	m_OpenList.clear();
+	m_Nodes.push_back( { headTile, 0, 0 } );
+	m_OpenList.push_back( { estimate( headTile ), 0 } );
+	this->MarkVisited( headTile, 0 );
+
+	// Search until a node at the end of the window or on an apple is reached. If there is none, the snake goes as far as it can.
+	uint32_t bestNode		= 0;
+	while ( !m_OpenList.empty() ) {
+		std::pop_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+		const uint32_t nodeIndex	= m_OpenList.back().Node;
+		const SearchNode node		= m_Nodes[nodeIndex];
+		m_OpenList.pop_back();
+		++m_NrOfExpandedNodes;
+
+		if ( node.Depth > m_Nodes[bestNode].Depth ) {
+			bestNode		= nodeIndex;
+		}
+		if ( node.Depth == COOPERATIVE_WINDOW || ( node.Depth > 0 && gameState.Board[node.Tile] == Tile::Apple ) ) {
+			bestNode		= nodeIndex;
+			break;
+		}
+
+		const uint32_t depth		= node.Depth + 1;
+		for ( int offset : neighbourOffsets ) {
+			const uint32_t neighbour		= static_cast<uint32_t>( static_cast<int>( node.Tile ) + offset );		// The blocked border of the board keeps neighbours inside the buffers.
+			if ( !gameState.IsTileWalkableAt( neighbour, tick + depth ) || this->IsReserved( neighbour, tick + depth, tick ) ||
+				 this->IsOnOwnPath( nodeIndex, neighbour, depth, snakeLength ) || !this->MarkVisited( neighbour, depth ) ) {
+				continue;
+			}
+			m_Nodes.push_back( { neighbour, depth, nodeIndex } );
+			m_OpenList.push_back( { depth + estimate( neighbour ), static_cast<uint32_t>( m_Nodes.size() - 1 ) } );
+			std::push_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+		}
+	}
+
+	this->Reserve( gameState, snake, bestNode, snakeLength );
+
+	// Walk back along the path to find the tile right after the head.
+	uint32_t nodeIndex		= bestNode;
+	while ( m_Nodes[nodeIndex].Depth > 1 ) {
+		nodeIndex		= m_Nodes[nodeIndex].Parent;
+	}
+	return m_Nodes[nodeIndex].Tile;
+}
+
+bool CooperativeAStar::IsOnOwnPath( uint32_t node, uint32_t tile, uint32_t depth, size_t snakeLength ) const {
+	// The body of the snake follows its head, so a tile the head passed is blocked until the whole snake has moved over it.
+	for ( ; m_Nodes[node].Depth > 0; node = m_Nodes[node].Parent ) {
+		if ( m_Nodes[node].Tile == tile && depth - m_Nodes[node].Depth < snakeLength ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CooperativeAStar::MarkVisited( uint32_t tile, uint32_t depth ) {
+	for ( size_t slot = GetSlot( tile, depth, m_Visits.size() ); ; slot = ( slot + 1 ) & ( m_Visits.size() - 1 ) ) {
+		Visit& visit		= m_Visits[slot];
+		if ( visit.Stamp != m_SearchStamp ) {
+			visit		= { tile, depth, m_SearchStamp };
+			return true;
+		}
+		if ( visit.Tile == tile && visit.Depth == depth ) {
+			return false;
+		}
+	}
+}
+
+void CooperativeAStar::Reserve( const GameState& gameState, const Snake& snake, uint32_t node, size_t snakeLength ) {
+	// Every tile on the path stays blocked from when the head arrives until the tail leaves it. A snake that eats an apple grows, so its tiles are blocked for the rest of the window.
+	const uint32_t tick			= gameState.Tick;
+	const uint32_t eatDepth		= m_Nodes[node].Depth;
+	const bool eatsApple		= gameState.Board[m_Nodes[node].Tile] == Tile::Apple;
+	for ( ; m_Nodes[node].Depth > 0; node = m_Nodes[node].Parent ) {
+		const uint32_t arrival		= m_Nodes[node].Depth;
+		const uint32_t leave		= eatsApple ? COOPERATIVE_WINDOW : static_cast<uint32_t>( std::min<size_t>( COOPERATIVE_WINDOW, arrival + snakeLength - 1 ) );
+		for ( uint32_t depth = arrival; depth <= leave; ++depth ) {
+			this->AddReservation( { m_Nodes[node].Tile, tick + depth, snake.Id, tick }, tick );
+		}
+	}
+
+	// Growing also keeps the segments on the board now there for longer than their free tick says, those still there when the apple is eaten stay SNAKE_GROWTH_PER_APPLE
+	// ticks longer. Only the segments closest to the tail free up within the window.
+	if ( eatsApple ) {
+		for ( size_t segmentIndex = snake.Segments.size(); segmentIndex-- > 0; ) {
+			const uint32_t tileIndex		= static_cast<uint32_t>( gameState.GetTileIndex( snake.Segments[segmentIndex] ) );
+			const uint32_t freeTick			= gameState.GetTileFreeTick( tileIndex );
+			if ( freeTick > tick + COOPERATIVE_WINDOW ) {
+				break;
+			}
+			if ( freeTick <= tick + eatDepth ) {
+				continue;		// Gone before the apple is eaten.
+			}
+			for ( uint32_t blockedTick = freeTick; blockedTick < freeTick + SNAKE_GROWTH_PER_APPLE && blockedTick <= tick + COOPERATIVE_WINDOW; ++blockedTick ) {
+				this->AddReservation( { tileIndex, blockedTick, snake.Id, tick }, tick );
+			}
+		}
+	}
+}
+
+bool CooperativeAStar::IsReserved( uint32_t tile, uint32_t tick, uint32_t currentTick ) const {
+	// Stale reservations are skipped over, only an empty slot ends the probe.
+	for ( size_t slot = GetSlot( tile, tick, m_Reservations.size() ); m_Reservations[slot].SnakeId != NO_SNAKE; slot = ( slot + 1 ) & ( m_Reservations.size() - 1 ) ) {
+		const Reservation& reservation		= m_Reservations[slot];
+		if ( reservation.Tile == tile && reservation.Tick == tick && this->IsValid( reservation, currentTick ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CooperativeAStar::IsValid( const Reservation& reservation, uint32_t currentTick ) const {
+	const SnakePlan& plan		= m_SnakePlans[reservation.SnakeId];
+	return reservation.Tick > currentTick && reservation.PlanTick == plan.PlanTick && plan.AliveTick == currentTick;
+}
+
+void CooperativeAStar::AddReservation( const Reservation& reservation, uint32_t currentTick ) {
+	// Rebuilding keeps at least half of the slots empty, so that probes stay short.
+	if ( 2 * ( m_NrOfUsedSlots + 1 ) > m_Reservations.size() ) {
+		this->RebuildReservations( currentTick );
+	}
+
+	// A stale reservation can be overwritten, the probes that pass its slot go on past it either way.
+	for ( size_t slot = GetSlot( reservation.Tile, reservation.Tick, m_Reservations.size() ); ; slot = ( slot + 1 ) & ( m_Reservations.size() - 1 ) ) {
+		Reservation& entry		= m_Reservations[slot];
+		if ( entry.SnakeId == NO_SNAKE ) {
+			++m_NrOfUsedSlots;
+		} else if ( this->IsValid( entry, currentTick ) ) {
+			continue;
+		}
+		entry		= reservation;
+		return;
+	}
+}
+
+void CooperativeAStar::RebuildReservations( uint32_t currentTick ) {
+	size_t nrOfValidReservations		= 0;
+	for ( const Reservation& reservation : m_Reservations ) {
+		nrOfValidReservations				+= reservation.SnakeId != NO_SNAKE && this->IsValid( reservation, currentTick );
+	}
+	size_t nrOfSlots					= m_Reservations.size();
+	while ( 4 * nrOfValidReservations > nrOfSlots ) {
+		nrOfSlots							*= 2;
+	}
+
+	std::swap( m_Reservations, m_OldReservations );
+	m_Reservations.assign( nrOfSlots, { 0, 0, NO_SNAKE, 0 } );
+	m_NrOfUsedSlots						= 0;
+	for ( const Reservation& reservation : m_OldReservations ) {
+		if ( reservation.SnakeId != NO_SNAKE && this->IsValid( reservation, currentTick ) ) {
+			size_t slot							= GetSlot( reservation.Tile, reservation.Tick, nrOfSlots );
+			while ( m_Reservations[slot].SnakeId != NO_SNAKE ) {
+				slot								= ( slot + 1 ) & ( nrOfSlots - 1 );
+			}
+			m_Reservations[slot]				= reservation;
+			++m_NrOfUsedSlots;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Player.h"
+
+#define COOPERATIVE_WINDOW			8			// Number of ticks ahead that each snake plans, and that the plans of a team are free of collisions with each other.
+#define COOPERATIVE_VISIT_SLOTS		1024		// Slots of the table of nodes visited by a search. A power of two, and at least twice the number of nodes a search can create.
+#define COOPERATIVE_MIN_RESERVATION_SLOTS	1024	// Slots the reservation table starts with, it grows when it gets crowded. A power of two.
+
+// Plans the snakes of a team one after the other with A* in space and time, over a window of COOPERATIVE_WINDOW ticks.
+// Each plan is written to a reservation table, marking the tiles its head passes and the time its body stays on them, and later snakes plan around it.
+// So the moves of a team never make its snakes run into each other within the window. Beyond the window the distance to an apple from the shared flow field is the estimate.
+// The reservation table is a hash table of the reserved tiles and ticks, so it is sized to the plans rather than the board. A plan stays reserved until the snake that
+// made it plans again, so the first snakes planned on a tick plan around what the others planned on the tick before.
+class CooperativeAStar : public Player {
+public:
+	void			MakeMoves						( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+
+	size_t			GetNrOfExpandedNodes			( ) const;		// Total number of nodes expanded by all searches so far.
+
+private:
+	struct SearchNode {
+		uint32_t	Tile;
+		uint32_t	Depth;			// Ticks after the current one.
+		uint32_t	Parent;			// Index into m_Nodes, the node itself for the root.
+	};
+	struct OpenNode {
+		uint32_t	F;				// Depth plus estimated distance to an apple.
+		uint32_t	Node;			// Index into m_Nodes.
+	};
+	struct Visit {
+		uint32_t	Tile;
+		uint32_t	Depth;
+		uint32_t	Stamp;			// Equal to m_SearchStamp if the slot was filled by the current search, empty otherwise.
+	};
+	struct Reservation {
+		uint32_t	Tile;
+		uint32_t	Tick;			// Update in which the tile is taken.
+		uint32_t	SnakeId;		// NO_SNAKE for empty slots.
+		uint32_t	PlanTick;		// Tick the plan was made on.
+	};
+	struct SnakePlan {
+		uint32_t	PlanTick		= 0;		// Tick of the latest plan of the snake, reservations from older plans are stale.
+		uint32_t	AliveTick		= 0;		// Latest tick the snake was alive on, reservations of snakes that have died are stale.
+	};
+
+	void			ResizeBuffers					( const Team& team );
+	uint32_t		PlanSnake						( const GameState& gameState, const Snake& snake, size_t snakeLength );
+	bool			IsOnOwnPath						( uint32_t node, uint32_t tile, uint32_t depth, size_t snakeLength ) const;
+	bool			MarkVisited						( uint32_t tile, uint32_t depth );		// Returns false if the current search has visited the tile at the depth already.
+
+	void			Reserve							( const GameState& gameState, const Snake& snake, uint32_t node, size_t snakeLength );
+	bool			IsReserved						( uint32_t tile, uint32_t tick, uint32_t currentTick ) const;
+	bool			IsValid							( const Reservation& reservation, uint32_t currentTick ) const;
+	void			AddReservation					( const Reservation& reservation, uint32_t currentTick );
+	void			RebuildReservations				( uint32_t currentTick );		// Drops the stale reservations, and grows the table if the valid ones take more than a quarter of it.
+
+	std::vector<Reservation>	m_Reservations;			// Open addressing with linear probing. Stale reservations are left in place until the table is rebuilt, new ones may take their slots.
+	std::vector<Reservation>	m_OldReservations;		// Buffer for rebuilding the table.
+	size_t						m_NrOfUsedSlots			= 0;		// Slots of m_Reservations that are not empty, stale or not.
+	std::vector<SnakePlan>		m_SnakePlans;			// Per snake id.
+
+	std::vector<Visit>			m_Visits;				// Open addressing with linear probing, COOPERATIVE_VISIT_SLOTS slots.
+	uint32_t					m_SearchStamp			= 0;
+
+	std::vector<SearchNode>		m_Nodes;				// Every node created by the current search, keeps its capacity between searches.
+	std::vector<OpenNode>		m_OpenList;				// Binary heap, keeps its capacity between searches.
+	size_t						m_NrOfExpandedNodes		= 0;
+};
@@ -0,0 +1,265 @@
+#include "DStarLite.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <glm/common.hpp>
+
+#define DSTAR_INFINITY			UINT32_MAX		// Cost of tiles from which the goal can't be reached.
+#define DSTAR_QUEUE_SLACK		4				// The queue is cleaned of stale entries when it holds this many entries per tile.
+
+static bool IsKeyLess( uint32_t lhsKey1, uint32_t lhsKey2, uint32_t rhsKey1, uint32_t rhsKey2 ) {
+	return lhsKey1 < rhsKey1 || ( lhsKey1 == rhsKey1 && lhsKey2 < rhsKey2 );
+}
+
+bool DStarLite::IsWorseEntry( const HeapEntry& lhs, const HeapEntry& rhs ) {
+	return IsKeyLess( rhs.Key1, rhs.Key2, lhs.Key1, lhs.Key2 );		// Lowest key on top of the heap.
+}
+
+void DStarLite::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+	const Team& team		= currentState.Teams[teamIndex];
+	const int stride		= static_cast<int>( currentState.BoardStride );
+
+	if ( m_ReservedStamps.size() != currentState.Board.size() ) {
+		m_ReservedStamps.assign( currentState.Board.size(), 0 );
+		m_ReserveStamp		= 0;
+	}
+	if ( ++m_ReserveStamp == 0 ) {		// See AStar::MakeMoves.
+		std::fill( m_ReservedStamps.begin(), m_ReservedStamps.end(), 0 );
+		m_ReserveStamp		= 1;
+	}
+
+	// Plans that weren't brought up to date last tick will start over, or belong to snakes that have died, so their buffers are handed on to the plans that start next.
+	for ( SnakePlan& plan : m_Plans ) {
+		if ( !plan.Tiles.empty() && plan.Tick + 1 < currentState.Tick ) {
+			m_DroppedPlans.push_back( std::move( plan ) );
+			plan		= SnakePlan();
+		}
+	}
+
+	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+		const Snake& snake			= team.Snakes[snakeIndex];
+		const uint32_t headTile		= static_cast<uint32_t>( currentState.GetTileIndex( snake.Segments[0] ) );
+		if ( snake.Id >= m_Plans.size() ) {
+			m_Plans.resize( snake.Id + 1 );
+		}
+		SnakePlan& plan				= m_Plans[snake.Id];
+
+		// Repair the plan if it is still heading for an apple and was brought up to date last tick, since then ChangedTiles holds every change. Otherwise start over.
+		const bool isPlanCurrent	= plan.Goal != DSTAR_NO_GOAL && currentState.Board[plan.Goal] == Tile::Apple && plan.Tick + 1 == currentState.Tick;
+		if ( isPlanCurrent ) {
+			const uint32_t previousStart		= plan.Start;
+			plan.KeyModifier					+= this->Estimate( currentState, previousStart, headTile );
+			plan.Start							= headTile;
+			this->UpdateTile( currentState, plan, previousStart );		// Stays blocked, so it isn't in ChangedTiles, but isn't the start anymore.
+			for ( uint32_t changedTile : currentState.ChangedTiles ) {
+				this->UpdateTile( currentState, plan, changedTile );
+				this->UpdateTile( currentState, plan, changedTile - stride );
+				this->UpdateTile( currentState, plan, changedTile - 1 );
+				this->UpdateTile( currentState, plan, changedTile + 1 );
+				this->UpdateTile( currentState, plan, changedTile + stride );
+			}
+		} else {
+			glm::ivec2 targetApple;
+			if ( !currentState.FindClosestApple( glm::vec2( snake.Segments[0] ), FLT_MAX, targetApple ) ) {
+				plan.Goal					= DSTAR_NO_GOAL;		// Nothing to plan towards, start over once an apple exists.
+				outMoves[snakeIndex]		= this->ChooseMove( currentState, plan, headTile, outMoves[snakeIndex] );
+				continue;
+			}
+			this->Initialize( currentState, plan, headTile, static_cast<uint32_t>( currentState.GetTileIndex( targetApple ) ) );
+		}
+		plan.Tick		= currentState.Tick;
+
+		this->ComputeShortestPath( currentState, plan );
+		outMoves[snakeIndex]		= this->ChooseMove( currentState, plan, headTile, outMoves[snakeIndex] );
+
+		// Reserve the tile so that team mates don't plan to move onto it as well.
+		m_ReservedStamps[currentState.GetTileIndex( snake.Segments[0] + ConvertMoveToIVec2( outMoves[snakeIndex] ) )]		= m_ReserveStamp;
+	}
+}
+
+size_t DStarLite::GetNrOfExpandedNodes() const {
+	return m_NrOfExpandedNodes;
+}
+
+void DStarLite::Initialize( const GameState& gameState, SnakePlan& plan, uint32_t start, uint32_t goal ) {
+	if ( plan.Tiles.size() != gameState.Board.size() ) {
+		if ( !m_DroppedPlans.empty() ) {
+			plan		= std::move( m_DroppedPlans.back() );
+			m_DroppedPlans.pop_back();
+		}
+		if ( plan.Tiles.size() != gameState.Board.size() ) {
+			plan.Tiles.assign( gameState.Board.size(), { DSTAR_INFINITY, DSTAR_INFINITY, 0, 0 } );
+			plan.Generation		= 0;
+		}
+	}
+
+	// Every tile of an earlier generation reads as untouched. When the generation wraps around, old ones could be mistaken for new ones, so they are cleared.
+	if ( ++plan.Generation == 0 ) {
+		std::fill( plan.Tiles.begin(), plan.Tiles.end(), TileState{ DSTAR_INFINITY, DSTAR_INFINITY, 0, 0 } );
+		plan.Generation		= 1;
+	}
+	plan.Queue.clear();
+	plan.LastSerial				= 0;
+	plan.Goal					= goal;
+	plan.Start					= start;
+	plan.KeyModifier			= 0;
+	this->GetTileState( plan, goal ).LookAhead		= 0;
+	this->Enqueue( plan, goal, this->Estimate( gameState, start, goal ), 0 );
+}
+
+void DStarLite::ComputeShortestPath( const GameState& gameState, SnakePlan& plan ) {
+	const int stride		= static_cast<int>( gameState.BoardStride );
+	auto calculateKey		= [&]( uint32_t tile, uint32_t& outKey1, uint32_t& outKey2 ) {
+		const TileState state		= this->ReadTileState( plan, tile );
+		outKey2		= std::min( state.Cost, state.LookAhead );
+		outKey1		= outKey2 == DSTAR_INFINITY ? DSTAR_INFINITY : outKey2 + this->Estimate( gameState, plan.Start, tile ) + plan.KeyModifier;
+	};
+
+	// Expand tiles until the start is consistent and no queued tile could still lower its cost.
+	HeapEntry top;
+	while ( this->PeekQueue( plan, top ) ) {
+		uint32_t startKey1, startKey2;
+		calculateKey( plan.Start, startKey1, startKey2 );
+		const TileState startState		= this->ReadTileState( plan, plan.Start );
+		if ( !IsKeyLess( top.Key1, top.Key2, startKey1, startKey2 ) && startState.Cost == startState.LookAhead ) {
+			break;
+		}
+		std::pop_heap( plan.Queue.begin(), plan.Queue.end(), IsWorseEntry );
+		plan.Queue.pop_back();
+		TileState& state		= this->GetTileState( plan, top.Tile );
+		state.QueueSerial		= 0;
+		++m_NrOfExpandedNodes;
+
+		const uint32_t tile		= top.Tile;
+		uint32_t key1, key2;
+		calculateKey( tile, key1, key2 );
+		if ( IsKeyLess( top.Key1, top.Key2, key1, key2 ) ) {		// The key grew since the tile was queued, as the start moved on.
+			this->Enqueue( plan, tile, key1, key2 );
+			continue;
+		}
+
+		if ( state.Cost > state.LookAhead ) {
+			state.Cost		= state.LookAhead;
+		} else {
+			state.Cost		= DSTAR_INFINITY;
+			this->UpdateTile( gameState, plan, tile );
+		}
+		this->UpdateTile( gameState, plan, tile - stride );
+		this->UpdateTile( gameState, plan, tile - 1 );
+		this->UpdateTile( gameState, plan, tile + 1 );
+		this->UpdateTile( gameState, plan, tile + stride );
+	}
+}
+
+void DStarLite::UpdateTile( const GameState& gameState, SnakePlan& plan, uint32_t tile ) {
+	// A tile can be moved through if it is walkable, and the head of the snake is always moved from. Blocked tiles are left unreachable.
+	const TileState previousState		= this->ReadTileState( plan, tile );
+	uint32_t lookAhead					= previousState.LookAhead;
+	if ( tile != plan.Goal ) {
+		lookAhead				= DSTAR_INFINITY;
+		if ( tile == plan.Start || !gameState.IsTileBlockedBit( tile ) ) {
+			const int stride					= static_cast<int>( gameState.BoardStride );
+			const int neighbourOffsets[4]		= { -stride, -1, 1, stride };
+			for ( int offset : neighbourOffsets ) {
+				const uint32_t neighbour		= static_cast<uint32_t>( static_cast<int>( tile ) + offset );		// Only open tiles and the start look at their neighbours, so the blocked border keeps them on the board.
+				const uint32_t cost				= this->ReadTileState( plan, neighbour ).Cost;
+				if ( cost != DSTAR_INFINITY && !gameState.IsTileBlockedBit( neighbour ) ) {
+					lookAhead		= std::min( lookAhead, cost + 1 );
+				}
+			}
+		}
+	}
+
+	// Most of the changed tiles are far from the search and stay untouched, which is left to the generation instead of being written.
+	if ( lookAhead == previousState.LookAhead && lookAhead == previousState.Cost && previousState.QueueSerial == 0 ) {
+		return;
+	}
+	TileState& state		= this->GetTileState( plan, tile );
+	state.LookAhead			= lookAhead;
+	state.QueueSerial		= 0;
+	if ( state.Cost != state.LookAhead ) {
+		const uint32_t key2		= std::min( state.Cost, state.LookAhead );
+		this->Enqueue( plan, tile, key2 + this->Estimate( gameState, plan.Start, tile ) + plan.KeyModifier, key2 );
+	}
+}
+
+void DStarLite::Enqueue( SnakePlan& plan, uint32_t tile, uint32_t key1, uint32_t key2 ) {
+	// Drop the stale entries once there are too many of them, instead of searching the heap each time a tile is requeued. Before the serials wrap around too,
+	// so that no stale entry can end up with the serial of its tile.
+	if ( plan.Queue.size() >= DSTAR_QUEUE_SLACK * plan.Tiles.size() || plan.LastSerial == UINT32_MAX ) {
+		this->CleanQueue( plan );
+	}
+
+	const uint32_t serial		= ++plan.LastSerial;
+	this->GetTileState( plan, tile ).QueueSerial		= serial;
+	plan.Queue.push_back( { key1, key2, tile, serial } );
+	std::push_heap( plan.Queue.begin(), plan.Queue.end(), IsWorseEntry );
+}
+
+void DStarLite::CleanQueue( SnakePlan& plan ) {
+	plan.Queue.erase( std::remove_if( plan.Queue.begin(), plan.Queue.end(), [this, &plan]( const HeapEntry& entry ) {
+		return this->ReadTileState( plan, entry.Tile ).QueueSerial != entry.Serial;
+	} ), plan.Queue.end() );
+	std::make_heap( plan.Queue.begin(), plan.Queue.end(), IsWorseEntry );
+
+	// Each queued tile has one entry left, so they can be numbered again without two entries of a tile sharing a serial.
+	plan.LastSerial		= 0;
+	for ( HeapEntry& entry : plan.Queue ) {
+		entry.Serial		= ++plan.LastSerial;
+		this->GetTileState( plan, entry.Tile ).QueueSerial		= entry.Serial;
+	}
+}
+
+bool DStarLite::PeekQueue( SnakePlan& plan, HeapEntry& outTop ) {
+	// Pop stale entries until the top of the heap is the entry its tile is queued with.
+	while ( !plan.Queue.empty() ) {
+		outTop		= plan.Queue.front();
+		if ( this->ReadTileState( plan, outTop.Tile ).QueueSerial == outTop.Serial ) {
+			return true;
+		}
+		std::pop_heap( plan.Queue.begin(), plan.Queue.end(), IsWorseEntry );
+		plan.Queue.pop_back();
+	}
+	return false;
+}
+
+DStarLite::TileState& DStarLite::GetTileState( SnakePlan& plan, uint32_t tile ) {
+	TileState& state		= plan.Tiles[tile];
+	if ( state.Generation != plan.Generation ) {
+		state					= { DSTAR_INFINITY, DSTAR_INFINITY, 0, plan.Generation };
+	}
+	return state;
+}
+
+DStarLite::TileState DStarLite::ReadTileState( const SnakePlan& plan, uint32_t tile ) const {
+	const TileState& state		= plan.Tiles[tile];
+	return state.Generation == plan.Generation ? state : TileState{ DSTAR_INFINITY, DSTAR_INFINITY, 0, plan.Generation };
+}
+
+uint32_t DStarLite::Estimate( const GameState& gameState, uint32_t from, uint32_t to ) const {
+	// Manhattan distance, exact on an empty 4-connected grid.
+	const int stride		= static_cast<int>( gameState.BoardStride );
+	return static_cast<uint32_t>( glm::abs( static_cast<int>( from ) % stride - static_cast<int>( to ) % stride ) + glm::abs( static_cast<int>( from ) / stride - static_cast<int>( to ) / stride ) );
+}
+
+Move DStarLite::ChooseMove( const GameState& gameState, const SnakePlan& plan, uint32_t headTile, Move previousMove ) const {
+	// Take the step towards the goal with the lowest cost, or else keep going the same way if possible, or else the first free direction.
+	const Move moves[5]		= { previousMove, Move::Up, Move::Left, Move::Down, Move::Right };
+	Move bestMove			= previousMove;
+	uint32_t bestCost		= DSTAR_INFINITY;
+	bool foundSafeMove		= false;
+	for ( Move move : moves ) {
+		const glm::ivec2 direction		= ConvertMoveToIVec2( move );
+		const uint32_t tile				= static_cast<uint32_t>( static_cast<int>( headTile ) + direction.y * static_cast<int>( gameState.BoardStride ) + direction.x );
+		if ( !gameState.IsTileWalkableAt( tile, gameState.Tick + 1 ) || m_ReservedStamps[tile] == m_ReserveStamp ) {
+			continue;
+		}
+		const uint32_t cost				= plan.Goal == DSTAR_NO_GOAL || gameState.IsTileBlockedBit( tile ) ? DSTAR_INFINITY : this->ReadTileState( plan, tile ).Cost;
+		if ( !foundSafeMove || cost < bestCost ) {
+			bestMove			= move;
+			bestCost			= cost;
+			foundSafeMove		= true;
+		}
+	}
+	return bestMove;
+}
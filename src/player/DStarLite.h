@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Player.h"
+
+#define DSTAR_NO_GOAL			UINT32_MAX		// Goal of plans that haven't started, or have no apple to go for.
+
+// Routes every snake to the apple closest to it with D* Lite, which keeps the search of each snake from one tick to the next and repairs it instead of searching again.
+// The search runs backwards from the apple, so the snake moving only changes the estimate, and each tick only the tiles in GameState::ChangedTiles are looked at again.
+// A snake searches from scratch when its apple is eaten, or if it missed a tick. The tiles of a plan are reset lazily, so starting over costs no more than the search itself.
+// Like JumpPointSearch the board is seen as it is now, snake segments don't move away.
+class DStarLite : public Player {
+public:
+	void			MakeMoves						( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+
+	size_t			GetNrOfExpandedNodes			( ) const;		// Total number of nodes expanded by all searches and repairs so far.
+
+private:
+	struct HeapEntry {
+		uint32_t	Key1;			// Cost plus estimate, compared first.
+		uint32_t	Key2;			// Cost.
+		uint32_t	Tile;
+		uint32_t	Serial;			// Stale unless equal to the QueueSerial of the tile.
+	};
+
+	// Search state of one tile in a plan. Only valid if its generation is the plan's, otherwise the plan hasn't touched the tile yet, and it has infinite costs and isn't queued.
+	struct TileState {
+		uint32_t	Cost;			// Cost of the tile to the goal as of its last expansion, g in D* Lite.
+		uint32_t	LookAhead;		// Cost of the tile to the goal through its best neighbour, rhs in D* Lite.
+		uint32_t	QueueSerial;	// Serial of the queue entry holding the tiles current key, 0 if the tile isn't queued.
+		uint32_t	Generation;
+	};
+
+	// Search state of one snake, kept between ticks. Starting over bumps the generation, which resets every tile at once.
+	struct SnakePlan {
+		std::vector<TileState>		Tiles;					// Indexed by tile, sized to the board once the plan is first started.
+		std::vector<HeapEntry>		Queue;					// Binary heap. Entries that don't hold the serial of their tile are stale and skipped.
+		uint32_t					Generation				= 0;
+		uint32_t					LastSerial				= 0;		// Serial of the last entry queued.
+		uint32_t					Goal					= DSTAR_NO_GOAL;
+		uint32_t					Start					= UINT32_MAX;
+		uint32_t					KeyModifier				= 0;		// Sum of the estimates between each start and the next, km in D* Lite.
+		uint32_t					Tick					= 0;		// Tick the plan was last brought up to date.
+	};
+
+	static bool		IsWorseEntry					( const HeapEntry& lhs, const HeapEntry& rhs );
+
+	void			Initialize						( const GameState& gameState, SnakePlan& plan, uint32_t start, uint32_t goal );
+	void			ComputeShortestPath				( const GameState& gameState, SnakePlan& plan );
+	void			UpdateTile						( const GameState& gameState, SnakePlan& plan, uint32_t tile );
+	void			Enqueue							( SnakePlan& plan, uint32_t tile, uint32_t key1, uint32_t key2 );
+	void			CleanQueue						( SnakePlan& plan );		// Drops the stale entries and numbers the rest from 1 again.
+	bool			PeekQueue						( SnakePlan& plan, HeapEntry& outTop );
+	TileState&		GetTileState					( SnakePlan& plan, uint32_t tile );		// Resets the tile first if the plan hasn't touched it yet.
+	TileState		ReadTileState					( const SnakePlan& plan, uint32_t tile ) const;
+	uint32_t		Estimate						( const GameState& gameState, uint32_t from, uint32_t to ) const;
+	Move			ChooseMove						( const GameState& gameState, const SnakePlan& plan, uint32_t headTile, Move previousMove ) const;
+
+	std::vector<SnakePlan>		m_Plans;				// Indexed by snake id.
+	std::vector<SnakePlan>		m_DroppedPlans;			// Plans of snakes that have died or fell behind, whose buffers new plans take over instead of allocating their own.
+	std::vector<uint32_t>		m_ReservedStamps;		// Equal to m_ReserveStamp for tiles that snakes earlier in the team have chosen to move to this tick.
+	uint32_t					m_ReserveStamp			= 0;
+	size_t						m_NrOfExpandedNodes		= 0;
+};
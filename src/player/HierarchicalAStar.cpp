@@ -0,0 +1,311 @@
+#include "HierarchicalAStar.h"
+
+#include <algorithm>
+#include <glm/common.hpp>
+
+#define HPA_NO_PATH			UINT32_MAX		// Distance between tiles that can't reach each other.
+#define NO_ENTRANCE			UINT32_MAX		// Entrance slot of tiles that are not entrances.
+
+bool HierarchicalAStar::FindPath( const GameState& gameState, uint32_t start, uint32_t goal, uint32_t& outFirstStep ) {
+	if ( start == goal ) {
+		return false;
+	}
+	this->ResizeBuffers( gameState );
+	this->UpdateClusters( gameState );
+
+	// Start a new search, see AStar::FindPath.
+	if ( m_SearchStamp >= UINT32_MAX - 3 ) {
+		std::fill( m_SearchStamps.begin(), m_SearchStamps.end(), 0 );
+		m_SearchStamp		= 0;
+	}
+	m_SearchStamp		+= 2;
+	const uint32_t openStamp		= m_SearchStamp;
+	const uint32_t closedStamp		= m_SearchStamp + 1;
+
+	// The start and goal are not entrances, so they are connected to the entrances of their clusters with a search inside each cluster.
+	const size_t startCluster		= this->GetClusterIndex( gameState, start );
+	const size_t goalCluster		= this->GetClusterIndex( gameState, goal );
+	this->SearchCluster( gameState, startCluster, start, m_StartDistances, m_StartParents );
+	this->SearchCluster( gameState, goalCluster, goal, m_GoalDistances, m_LocalParents );
+
+	// The neighbours of the start across the border of its cluster are connected to the entrances of their clusters with a search inside each of them too.
+	const int neighbourOffsets[4]		= { -static_cast<int>( gameState.BoardStride ), -1, 1, static_cast<int>( gameState.BoardStride ) };
+	m_NrOfBorderNeighbours				= 0;
+	for ( int offset : neighbourOffsets ) {
+		const uint32_t neighbour		= static_cast<uint32_t>( static_cast<int>( start ) + offset );		// Tiles off the board are never walkable, so only tiles on it get a cluster.
+		if ( gameState.IsTileWalkableAt( neighbour, gameState.Tick + 1 ) && m_ReservedStamps[neighbour] != m_ReserveStamp && this->GetClusterIndex( gameState, neighbour ) != startCluster ) {
+			this->SearchCluster( gameState, this->GetClusterIndex( gameState, neighbour ), neighbour, m_NeighbourDistances[m_NrOfBorderNeighbours], m_LocalParents );
+			m_BorderNeighbours[m_NrOfBorderNeighbours++]		= neighbour;
+		}
+	}
+
+	const uint32_t stride				= static_cast<uint32_t>( gameState.BoardStride );
+	auto heuristic						= [&]( uint32_t tile ) {		// Manhattan distance, never more than the distance on the board.
+		return static_cast<uint32_t>( glm::abs( static_cast<int>( tile % stride ) - static_cast<int>( goal % stride ) ) + glm::abs( static_cast<int>( tile / stride ) - static_cast<int>( goal / stride ) ) );
+	};
+	auto isWorseNode					= []( const OpenNode& lhs, const OpenNode& rhs ) {
+		return lhs.F > rhs.F || ( lhs.F == rhs.F && lhs.G < rhs.G );
+	};
+	auto addEdge						= [&]( uint32_t from, uint32_t to, uint32_t costSoFar ) {
+		if ( m_SearchStamps[to] == closedStamp || ( m_SearchStamps[to] == openStamp && m_CostSoFar[to] <= costSoFar ) ) {
+			return;
+		}
+		m_SearchStamps[to]		= openStamp;
+		m_CostSoFar[to]			= costSoFar;
+		m_CameFrom[to]			= from;
+		m_OpenList.push_back( { costSoFar + heuristic( to ), costSoFar, to } );
+		std::push_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+	};
+
+	m_OpenList.clear();
+	m_CostSoFar[start]			= 0;
+	m_CameFrom[start]			= start;
+	m_SearchStamps[start]		= openStamp;
+	m_OpenList.push_back( { heuristic( start ), 0, start } );
+
+	while ( !m_OpenList.empty() ) {
+		std::pop_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+		const OpenNode node		= m_OpenList.back();
+		m_OpenList.pop_back();
+
+		if ( m_SearchStamps[node.Tile] == closedStamp ) {
+			continue;
+		}
+		m_SearchStamps[node.Tile]		= closedStamp;
+		++m_NrOfExpandedNodes;
+
+		if ( node.Tile == goal ) {
+			// Walk back to the first node on the path. A neighbour of the start across the border is the first step itself, otherwise the node is in the cluster
+			// of the start, and the way there is refined with the search from the start.
+			uint32_t tile		= goal;
+			while ( m_CameFrom[tile] != start ) {
+				tile		= m_CameFrom[tile];
+			}
+			while ( this->GetClusterIndex( gameState, tile ) == startCluster && m_StartParents[this->GetLocalIndex( gameState, tile )] != start ) {		// Unless the start is an entrance and the path crosses the border right away.
+				tile		= m_StartParents[this->GetLocalIndex( gameState, tile )];
+			}
+			outFirstStep		= tile;
+			// The clusters don't know about the tiles reserved by team mates or snakes that will have moved onto a tile next tick, so the first step is checked here.
+			return gameState.IsTileWalkableAt( outFirstStep, gameState.Tick + 1 ) && m_ReservedStamps[outFirstStep] != m_ReserveStamp;
+		}
+
+		if ( node.Tile == start ) {
+			for ( const Entrance& entrance : m_Clusters[startCluster].Entrances ) {
+				const uint32_t distance		= m_StartDistances[this->GetLocalIndex( gameState, entrance.Tile )];
+				if ( distance != HPA_NO_PATH ) {
+					addEdge( start, entrance.Tile, distance );
+				}
+			}
+			if ( startCluster == goalCluster && m_StartDistances[this->GetLocalIndex( gameState, goal )] != HPA_NO_PATH ) {
+				addEdge( start, goal, m_StartDistances[this->GetLocalIndex( gameState, goal )] );
+			}
+			for ( size_t neighbourIndex = 0; neighbourIndex < m_NrOfBorderNeighbours; ++neighbourIndex ) {
+				addEdge( start, m_BorderNeighbours[neighbourIndex], 1 );
+			}
+			if ( m_EntranceSlots[start] == NO_ENTRANCE ) {		// The head of a snake is blocked, so it is never an entrance, but a start given to FindPath directly may be.
+				continue;
+			}
+		}
+
+		// A neighbour of the start across the border leads to the entrances of its cluster, and to the goal if it is in the same cluster. If it is an entrance itself,
+		// it leads on like any other entrance too.
+		const uint32_t* borderNeighbour		= std::find( m_BorderNeighbours, m_BorderNeighbours + m_NrOfBorderNeighbours, node.Tile );
+		if ( node.G == 1 && borderNeighbour != m_BorderNeighbours + m_NrOfBorderNeighbours ) {
+			const std::vector<uint32_t>& distances		= m_NeighbourDistances[borderNeighbour - m_BorderNeighbours];
+			const size_t neighbourCluster				= this->GetClusterIndex( gameState, node.Tile );
+			for ( const Entrance& entrance : m_Clusters[neighbourCluster].Entrances ) {
+				const uint32_t distance		= distances[this->GetLocalIndex( gameState, entrance.Tile )];
+				if ( distance != HPA_NO_PATH ) {
+					addEdge( node.Tile, entrance.Tile, node.G + distance );
+				}
+			}
+			if ( neighbourCluster == goalCluster && distances[this->GetLocalIndex( gameState, goal )] != HPA_NO_PATH ) {
+				addEdge( node.Tile, goal, node.G + distances[this->GetLocalIndex( gameState, goal )] );
+			}
+			if ( m_EntranceSlots[node.Tile] == NO_ENTRANCE ) {
+				continue;
+			}
+		}
+
+		// Every other node is an entrance. It leads to the other entrances of its cluster, across the border, and to the goal if it is in the same cluster.
+		const size_t clusterIndex		= this->GetClusterIndex( gameState, node.Tile );
+		const Cluster& cluster			= m_Clusters[clusterIndex];
+		const uint32_t slot				= m_EntranceSlots[node.Tile];
+		const size_t nrOfEntrances		= cluster.Entrances.size();
+		for ( size_t otherSlot = 0; otherSlot < nrOfEntrances; ++otherSlot ) {
+			const uint32_t distance		= cluster.Distances[slot * nrOfEntrances + otherSlot];
+			if ( otherSlot != slot && distance != HPA_NO_PATH ) {
+				addEdge( node.Tile, cluster.Entrances[otherSlot].Tile, node.G + distance );
+			}
+		}
+		for ( uint32_t partnerIndex = 0; partnerIndex < cluster.Entrances[slot].NrOfPartners; ++partnerIndex ) {
+			addEdge( node.Tile, cluster.Entrances[slot].Partners[partnerIndex], node.G + 1 );
+		}
+		if ( clusterIndex == goalCluster && m_GoalDistances[this->GetLocalIndex( gameState, node.Tile )] != HPA_NO_PATH ) {
+			addEdge( node.Tile, goal, node.G + m_GoalDistances[this->GetLocalIndex( gameState, node.Tile )] );
+		}
+	}
+	return false;
+}
+
+size_t HierarchicalAStar::GetNrOfClusterRebuilds() const {
+	return m_NrOfClusterRebuilds;
+}
+
+void HierarchicalAStar::UpdateClusters( const GameState& gameState ) {
+	if ( m_EntranceSlots.size() != gameState.Board.size() ) {
+		m_GridSize		= ( glm::ivec2( gameState.Size ) + HPA_CLUSTER_SIZE - 1 ) / HPA_CLUSTER_SIZE;		// Rounded up so that every tile is in a cluster.
+		m_Clusters.assign( m_GridSize.x * m_GridSize.y, Cluster() );
+		m_EntranceSlots.assign( gameState.Board.size(), NO_ENTRANCE );
+		m_LocalDistances.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		m_LocalParents.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		m_StartDistances.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		m_StartParents.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		m_GoalDistances.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		for ( std::vector<uint32_t>& distances : m_NeighbourDistances ) {
+			distances.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		}
+		m_LocalQueue.resize( HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE );
+		m_ClusterTick	= UINT32_MAX;
+	}
+	if ( m_ClusterTick == gameState.Tick ) {
+		return;
+	}
+
+	// ChangedTiles holds every change since the last tick, so if the clusters were brought up to date then, only the clusters it touches are rebuilt. Otherwise all of them are.
+	if ( m_ClusterTick != UINT32_MAX && m_ClusterTick + 1 == gameState.Tick ) {
+		for ( uint32_t changedTile : gameState.ChangedTiles ) {
+			this->MarkDirty( gameState, changedTile );
+		}
+	} else {
+		for ( size_t clusterIndex = 0; clusterIndex < m_Clusters.size(); ++clusterIndex ) {
+			if ( !m_Clusters[clusterIndex].IsDirty ) {
+				m_Clusters[clusterIndex].IsDirty		= true;
+				m_DirtyClusters.push_back( clusterIndex );
+			}
+		}
+	}
+	m_ClusterTick		= gameState.Tick;
+
+	for ( size_t clusterIndex : m_DirtyClusters ) {
+		this->RebuildCluster( gameState, clusterIndex );
+		m_Clusters[clusterIndex].IsDirty		= false;
+	}
+	m_DirtyClusters.clear();
+}
+
+void HierarchicalAStar::MarkDirty( const GameState& gameState, uint32_t tile ) {
+	// The entrances on a border depend on the tiles on both sides of it, so a tile on the edge of its cluster also makes the cluster across the edge dirty.
+	const glm::ivec2 position		= glm::ivec2( static_cast<int>( tile % gameState.BoardStride ), static_cast<int>( tile / gameState.BoardStride ) ) - BOARD_PADDING;
+	const glm::ivec2 cluster		= position / HPA_CLUSTER_SIZE;
+	const glm::ivec2 local			= position - cluster * HPA_CLUSTER_SIZE;
+	auto markCluster				= [this]( const glm::ivec2& cluster ) {
+		Cluster& dirtyCluster		= m_Clusters[cluster.y * m_GridSize.x + cluster.x];
+		if ( !dirtyCluster.IsDirty ) {
+			dirtyCluster.IsDirty		= true;
+			m_DirtyClusters.push_back( cluster.y * m_GridSize.x + cluster.x );
+		}
+	};
+
+	markCluster( cluster );
+	if ( local.x == 0						&& cluster.x > 0				) { markCluster( cluster - glm::ivec2( 1, 0 ) ); }
+	if ( local.x == HPA_CLUSTER_SIZE - 1	&& cluster.x + 1 < m_GridSize.x	) { markCluster( cluster + glm::ivec2( 1, 0 ) ); }
+	if ( local.y == 0						&& cluster.y > 0				) { markCluster( cluster - glm::ivec2( 0, 1 ) ); }
+	if ( local.y == HPA_CLUSTER_SIZE - 1	&& cluster.y + 1 < m_GridSize.y	) { markCluster( cluster + glm::ivec2( 0, 1 ) ); }
+}
+
+void HierarchicalAStar::RebuildCluster( const GameState& gameState, size_t clusterIndex ) {
+	Cluster& cluster		= m_Clusters[clusterIndex];
+	for ( const Entrance& entrance : cluster.Entrances ) {
+		m_EntranceSlots[entrance.Tile]		= NO_ENTRANCE;
+	}
+	cluster.Entrances.clear();
+
+	// Find the entrances on each border that has a cluster on the other side.
+	const glm::ivec2 clusterPosition	= glm::ivec2( static_cast<int>( clusterIndex ) % m_GridSize.x, static_cast<int>( clusterIndex ) / m_GridSize.x );
+	const glm::ivec2 origin				= clusterPosition * HPA_CLUSTER_SIZE;
+	const glm::ivec2 end				= glm::min( origin + HPA_CLUSTER_SIZE, glm::ivec2( gameState.Size ) );
+	const glm::ivec2 size				= end - origin;
+	if ( clusterPosition.y > 0					) { this->AddEntrances( gameState, cluster, origin,								glm::ivec2( 1, 0 ), size.x, glm::ivec2(  0, -1 ) ); }
+	if ( clusterPosition.y + 1 < m_GridSize.y	) { this->AddEntrances( gameState, cluster, glm::ivec2( origin.x, end.y - 1 ),	glm::ivec2( 1, 0 ), size.x, glm::ivec2(  0,  1 ) ); }
+	if ( clusterPosition.x > 0					) { this->AddEntrances( gameState, cluster, origin,								glm::ivec2( 0, 1 ), size.y, glm::ivec2( -1,  0 ) ); }
+	if ( clusterPosition.x + 1 < m_GridSize.x	) { this->AddEntrances( gameState, cluster, glm::ivec2( end.x - 1, origin.y ),	glm::ivec2( 0, 1 ), size.y, glm::ivec2(  1,  0 ) ); }
+
+	// Find the distances between the entrances, without leaving the cluster.
+	const size_t nrOfEntrances		= cluster.Entrances.size();
+	cluster.Distances.resize( nrOfEntrances * nrOfEntrances );
+	for ( size_t slot = 0; slot < nrOfEntrances; ++slot ) {
+		this->SearchCluster( gameState, clusterIndex, cluster.Entrances[slot].Tile, m_LocalDistances, m_LocalParents );
+		for ( size_t otherSlot = 0; otherSlot < nrOfEntrances; ++otherSlot ) {
+			cluster.Distances[slot * nrOfEntrances + otherSlot]		= m_LocalDistances[this->GetLocalIndex( gameState, cluster.Entrances[otherSlot].Tile )];
+		}
+	}
+	++m_NrOfClusterRebuilds;
+}
+
+void HierarchicalAStar::AddEntrances( const GameState& gameState, Cluster& cluster, const glm::ivec2& first, const glm::ivec2& step, int length, const glm::ivec2& across ) {
+	// Each run of walkable tiles facing walkable tiles across the border gets one entrance in its middle. The cluster across finds the same runs, so the entrances pair up.
+	int runStart		= -1;
+	for ( int i = 0; i <= length; ++i ) {
+		const glm::ivec2 tile		= first + i * step;
+		const bool isOpen			= i < length && gameState.IsTileWalkable( tile ) && gameState.IsTileWalkable( tile + across );
+		if ( isOpen && runStart < 0 ) {
+			runStart		= i;
+		} else if ( !isOpen && runStart >= 0 ) {
+			const glm::ivec2 entrance		= first + ( ( runStart + i - 1 ) / 2 ) * step;
+			const uint32_t entranceTile		= static_cast<uint32_t>( gameState.GetTileIndex( entrance ) );
+			const uint32_t partnerTile		= static_cast<uint32_t>( gameState.GetTileIndex( entrance + across ) );
+			uint32_t& slot					= m_EntranceSlots[entranceTile];
+			if ( slot == NO_ENTRANCE ) {
+				slot		= static_cast<uint32_t>( cluster.Entrances.size() );
+				cluster.Entrances.push_back( { entranceTile, { partnerTile, 0 }, 1 } );
+			} else {
+				cluster.Entrances[slot].Partners[cluster.Entrances[slot].NrOfPartners++]		= partnerTile;
+			}
+			runStart		= -1;
+		}
+	}
+}
+
+void HierarchicalAStar::SearchCluster( const GameState& gameState, size_t clusterIndex, uint32_t source, std::vector<uint32_t>& outDistances, std::vector<uint32_t>& outParents ) {
+	// Breadth first search from the source over the walkable tiles of the cluster. The source itself may be blocked, like the head of a snake.
+	const glm::ivec2 origin		= glm::ivec2( static_cast<int>( clusterIndex ) % m_GridSize.x, static_cast<int>( clusterIndex ) / m_GridSize.x ) * HPA_CLUSTER_SIZE;
+	const glm::ivec2 end		= glm::min( origin + HPA_CLUSTER_SIZE, glm::ivec2( gameState.Size ) );
+	std::fill( outDistances.begin(), outDistances.end(), HPA_NO_PATH );
+
+	const int stride					= static_cast<int>( gameState.BoardStride );
+	const int neighbourOffsets[4]		= { -stride, -1, 1, stride };
+	size_t queueEnd						= 0;
+	outDistances[this->GetLocalIndex( gameState, source )]		= 0;
+	outParents[this->GetLocalIndex( gameState, source )]		= source;
+	m_LocalQueue[queueEnd++]									= source;
+	for ( size_t queueBegin = 0; queueBegin < queueEnd; ++queueBegin ) {
+		const uint32_t tile		= m_LocalQueue[queueBegin];
+		const uint32_t distance	= outDistances[this->GetLocalIndex( gameState, tile )];
+		for ( int offset : neighbourOffsets ) {
+			const uint32_t neighbour		= static_cast<uint32_t>( static_cast<int>( tile ) + offset );
+			const glm::ivec2 position		= glm::ivec2( static_cast<int>( neighbour ) % stride, static_cast<int>( neighbour ) / stride ) - BOARD_PADDING;
+			if ( position.x < origin.x || position.y < origin.y || position.x >= end.x || position.y >= end.y || gameState.IsTileBlockedBit( neighbour ) ) {
+				continue;
+			}
+			const size_t localIndex		= this->GetLocalIndex( gameState, neighbour );
+			if ( outDistances[localIndex] == HPA_NO_PATH ) {
+				outDistances[localIndex]	= distance + 1;
+				outParents[localIndex]		= tile;
+				m_LocalQueue[queueEnd++]	= neighbour;
+			}
+		}
+	}
+}
+
+size_t HierarchicalAStar::GetClusterIndex( const GameState& gameState, uint32_t tile ) const {
+	const glm::ivec2 position		= glm::ivec2( static_cast<int>( tile % gameState.BoardStride ), static_cast<int>( tile / gameState.BoardStride ) ) - BOARD_PADDING;
+	const glm::ivec2 cluster		= position / HPA_CLUSTER_SIZE;
+	return cluster.y * m_GridSize.x + cluster.x;
+}
+
+size_t HierarchicalAStar::GetLocalIndex( const GameState& gameState, uint32_t tile ) const {
+	const glm::ivec2 position		= glm::ivec2( static_cast<int>( tile % gameState.BoardStride ), static_cast<int>( tile / gameState.BoardStride ) ) - BOARD_PADDING;
+	const glm::ivec2 local			= position - ( position / HPA_CLUSTER_SIZE ) * HPA_CLUSTER_SIZE;
+	return local.y * HPA_CLUSTER_SIZE + local.x;
+}
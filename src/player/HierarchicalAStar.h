@@ -0,0 +1,57 @@
+#pragma once
+
+#include "AStar.h"
+
+#define HPA_CLUSTER_SIZE		10		// Width and height in tiles of each cluster.
+
+// Same as AStar, but searches with HPA*. The board is divided into square clusters, and wherever two neighbouring clusters have a run of walkable tiles facing each other
+// across their border, the middle of the run is an entrance. The search runs on the graph of entrances, using the distances between the entrances of each cluster,
+// and only the part of the path inside the cluster of the snake is refined into tiles. A head next to the border of its cluster also steps straight across it,
+// through a search of the cluster on the other side, instead of only through the entrances, which its own body shifts around from one tick to the next.
+// The clusters are kept between ticks, and only the clusters with a tile in GameState::ChangedTiles, or an entrance depending on one, are rebuilt.
+// Like JumpPointSearch the board is seen as it is now, snake segments don't move away.
+class HierarchicalAStar : public AStar {
+public:
+					// Brings the clusters up to date first if the state is at a new tick.
+	bool			FindPath						( const GameState& gameState, uint32_t start, uint32_t goal, uint32_t& outFirstStep ) override;
+
+	size_t			GetNrOfClusterRebuilds			( ) const;		// Total number of clusters rebuilt so far.
+
+private:
+	struct Entrance {
+		uint32_t	Tile;
+		uint32_t	Partners[2];	// Entrance tiles across the border in neighbouring clusters. A tile in the corner of a cluster can be on two borders.
+		uint32_t	NrOfPartners;
+	};
+	struct Cluster {
+		std::vector<Entrance>	Entrances;
+		std::vector<uint32_t>	Distances;		// Shortest distance inside the cluster between each pair of entrances, Entrances.size() squared entries.
+		bool					IsDirty;
+	};
+
+	void			UpdateClusters					( const GameState& gameState );
+	void			MarkDirty						( const GameState& gameState, uint32_t tile );
+	void			RebuildCluster					( const GameState& gameState, size_t clusterIndex );
+	void			AddEntrances					( const GameState& gameState, Cluster& cluster, const glm::ivec2& first, const glm::ivec2& step, int length, const glm::ivec2& across );
+	void			SearchCluster					( const GameState& gameState, size_t clusterIndex, uint32_t source, std::vector<uint32_t>& outDistances, std::vector<uint32_t>& outParents );
+	size_t			GetClusterIndex					( const GameState& gameState, uint32_t tile ) const;
+	size_t			GetLocalIndex					( const GameState& gameState, uint32_t tile ) const;
+
+	glm::ivec2					m_GridSize				= glm::ivec2( 0 );		// Number of clusters in each direction.
+	std::vector<Cluster>		m_Clusters;
+	std::vector<uint32_t>		m_EntranceSlots;		// One entry per tile, index of the tile in its clusters Entrances or UINT32_MAX.
+	std::vector<size_t>			m_DirtyClusters;
+	uint32_t					m_ClusterTick			= UINT32_MAX;			// Tick the clusters were last brought up to date, UINT32_MAX before the first time.
+	size_t						m_NrOfClusterRebuilds	= 0;
+
+	// Breadth first searches inside one cluster, indexed by the position of the tile in the cluster.
+	std::vector<uint32_t>		m_LocalDistances;
+	std::vector<uint32_t>		m_LocalParents;
+	std::vector<uint32_t>		m_StartDistances;
+	std::vector<uint32_t>		m_StartParents;
+	std::vector<uint32_t>		m_GoalDistances;
+	std::vector<uint32_t>		m_NeighbourDistances[4];	// From each neighbour of the start that is in another cluster.
+	uint32_t					m_BorderNeighbours[4];		// Those neighbours.
+	size_t						m_NrOfBorderNeighbours	= 0;
+	std::vector<uint32_t>		m_LocalQueue;
+};
@@ -17,7 +17,7 @@ void MoveIfKeyPressed( sf::Keyboard::Key key1, sf::Keyboard::Key key2, Move cond
 	}
 }
 
-void Human::MakeMoves( const GameState currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+void Human::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
 	// Make the move of each snake in the team equal to the direction the human player presses on the keyboard.
 	for ( auto& outSnakeMove : outMoves ) {
 		MoveIfKeyPressed( KEY_1_MOVE_UP,		KEY_2_MOVE_UP,			Move::Up,			outSnakeMove );
@@ -4,5 +4,5 @@
 
 class Human : public Player {
 public:
-	void			MakeMoves			( const GameState currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+	void			MakeMoves			( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
 };
@@ -0,0 +1,167 @@
+#include "JumpPointSearch.h"
+
+#include <algorithm>
+#include <glm/common.hpp>
+#include "../BitUtility.h"
+
+#define NO_JUMP_POINT		UINT32_MAX
+#define JUMP_SCAN_WIDTH		62		// Tiles scanned per word by a horizontal jump, one less than fits in a word since the tile before them is read as well.
+
+bool JumpPointSearch::FindPath( const GameState& gameState, uint32_t start, uint32_t goal, uint32_t& outFirstStep ) {
+	if ( start == goal ) {
+		return false;
+	}
+	this->ResizeBuffers( gameState );
+
+	// Start a new search, see AStar::FindPath.
+	if ( m_SearchStamp >= UINT32_MAX - 3 ) {
+		std::fill( m_SearchStamps.begin(), m_SearchStamps.end(), 0 );
+		m_SearchStamp		= 0;
+	}
+	m_SearchStamp		+= 2;
+	const uint32_t openStamp		= m_SearchStamp;
+	const uint32_t closedStamp		= m_SearchStamp + 1;
+
+	const uint32_t stride				= static_cast<uint32_t>( gameState.BoardStride );
+	auto distance						= [stride]( uint32_t from, uint32_t to ) {		// Manhattan distance, the cost of a jump and the heuristic.
+		return static_cast<uint32_t>( glm::abs( static_cast<int>( from % stride ) - static_cast<int>( to % stride ) ) + glm::abs( static_cast<int>( from / stride ) - static_cast<int>( to / stride ) ) );
+	};
+	auto isWorseNode					= []( const OpenNode& lhs, const OpenNode& rhs ) {
+		return lhs.F > rhs.F || ( lhs.F == rhs.F && lhs.G < rhs.G );
+	};
+	auto addJumpPoint					= [&]( uint32_t from, uint32_t jumpPoint, uint32_t fromCost ) {
+		if ( jumpPoint == NO_JUMP_POINT || m_SearchStamps[jumpPoint] == closedStamp ) {
+			return;
+		}
+		const uint32_t costSoFar		= fromCost + distance( from, jumpPoint );
+		if ( m_SearchStamps[jumpPoint] == openStamp && m_CostSoFar[jumpPoint] <= costSoFar ) {
+			return;
+		}
+		m_SearchStamps[jumpPoint]		= openStamp;
+		m_CostSoFar[jumpPoint]			= costSoFar;
+		m_CameFrom[jumpPoint]			= from;
+		m_OpenList.push_back( { costSoFar + distance( jumpPoint, goal ), costSoFar, jumpPoint } );
+		std::push_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+	};
+
+	m_OpenList.clear();
+	m_CostSoFar[start]			= 0;
+	m_CameFrom[start]			= start;
+	m_SearchStamps[start]		= openStamp;
+	m_OpenList.push_back( { distance( start, goal ), 0, start } );
+
+	while ( !m_OpenList.empty() ) {
+		std::pop_heap( m_OpenList.begin(), m_OpenList.end(), isWorseNode );
+		const OpenNode node		= m_OpenList.back();
+		m_OpenList.pop_back();
+
+		if ( m_SearchStamps[node.Tile] == closedStamp ) {
+			continue;
+		}
+		m_SearchStamps[node.Tile]		= closedStamp;
+		++m_NrOfExpandedNodes;
+
+		if ( node.Tile == goal ) {
+			// Walk back to the first jump point, every jump is a straight line so the first step is one tile from the start towards it.
+			uint32_t tile		= goal;
+			while ( m_CameFrom[tile] != start ) {
+				tile		= m_CameFrom[tile];
+			}
+			if ( tile / stride == start / stride ) {
+				outFirstStep		= tile < start ? start - 1 : start + 1;
+			} else {
+				outFirstStep		= tile < start ? start - stride : start + stride;
+			}
+			// The jumps don't know about the tiles reserved by team mates or snakes that will have moved onto a tile next tick, so the first step is checked here.
+			return gameState.IsTileWalkableAt( outFirstStep, gameState.Tick + 1 ) && m_ReservedStamps[outFirstStep] != m_ReserveStamp;
+		}
+
+		// Prune the directions that a shortest path can't take from the jump point, given the direction it was reached from.
+		// Shortest paths can always be rearranged to turn from horizontal to vertical as early as possible, which is next to a blocked tile, but may turn from vertical to horizontal anywhere.
+		const uint32_t parent		= m_CameFrom[node.Tile];
+		if ( node.Tile == start ) {
+			addJumpPoint( node.Tile, this->JumpHorizontal( gameState, node.Tile, -1, goal ), node.G );
+			addJumpPoint( node.Tile, this->JumpHorizontal( gameState, node.Tile, 1, goal ), node.G );
+			addJumpPoint( node.Tile, this->JumpVertical( gameState, node.Tile, -1, goal ), node.G );
+			addJumpPoint( node.Tile, this->JumpVertical( gameState, node.Tile, 1, goal ), node.G );
+		} else if ( node.Tile / stride == parent / stride ) {
+			const int direction		= node.Tile < parent ? -1 : 1;
+			const uint32_t behind	= node.Tile - direction;
+			addJumpPoint( node.Tile, this->JumpHorizontal( gameState, node.Tile, direction, goal ), node.G );
+			if ( gameState.IsTileBlockedBit( behind - stride ) ) {
+				addJumpPoint( node.Tile, this->JumpVertical( gameState, node.Tile, -1, goal ), node.G );
+			}
+			if ( gameState.IsTileBlockedBit( behind + stride ) ) {
+				addJumpPoint( node.Tile, this->JumpVertical( gameState, node.Tile, 1, goal ), node.G );
+			}
+		} else {
+			addJumpPoint( node.Tile, this->JumpVertical( gameState, node.Tile, node.Tile < parent ? -1 : 1, goal ), node.G );
+			addJumpPoint( node.Tile, this->JumpHorizontal( gameState, node.Tile, -1, goal ), node.G );
+			addJumpPoint( node.Tile, this->JumpHorizontal( gameState, node.Tile, 1, goal ), node.G );
+		}
+	}
+	return false;
+}
+
+uint32_t JumpPointSearch::JumpHorizontal( const GameState& gameState, uint32_t from, int direction, uint32_t goal ) const {
+	// A tile is a jump point if the goal is on it, or if the tile above or below it is open while the one behind that is blocked, which is where a shortest path may turn.
+	// The scan ends without a jump point at the first blocked tile, the blocked border makes sure there is one.
+	const size_t stride				= gameState.BoardStride;
+	const bool goalInRow			= goal / stride == from / stride;
+	if ( direction > 0 ) {
+		const uint64_t scannedMask	= LowBitsMask( JUMP_SCAN_WIDTH + 1 ) & ~uint64_t( 1 );
+		for ( size_t tile = from + 1; ; tile += JUMP_SCAN_WIDTH ) {
+			// Bit 0 is the tile before the scanned ones, bit i the tile i - 1 steps after it.
+			const uint64_t row		= gameState.GetBlockedBits( tile - 1, JUMP_SCAN_WIDTH + 1 );
+			const uint64_t above	= gameState.GetBlockedBits( tile - 1 - stride, JUMP_SCAN_WIDTH + 1 );
+			const uint64_t below	= gameState.GetBlockedBits( tile - 1 + stride, JUMP_SCAN_WIDTH + 1 );
+			uint64_t jumpPoints		= ( ( ~above & ( above << 1 ) ) | ( ~below & ( below << 1 ) ) ) & scannedMask;
+			if ( goalInRow && tile <= goal && goal < tile + JUMP_SCAN_WIDTH ) {
+				jumpPoints			|= uint64_t( 1 ) << ( goal - tile + 1 );
+			}
+			const uint64_t blocked	= row & scannedMask;
+			if ( jumpPoints != 0 && ( blocked == 0 || CountTrailingZeros( jumpPoints ) < CountTrailingZeros( blocked ) ) ) {
+				return static_cast<uint32_t>( tile - 1 + CountTrailingZeros( jumpPoints ) );
+			}
+			if ( blocked != 0 ) {
+				return NO_JUMP_POINT;
+			}
+		}
+	} else {
+		for ( size_t tile = from - 1; ; ) {
+			// Scan the tiles up to and including tile, going left. Fewer are scanned near the start of the board so that the row above stays inside it.
+			// Bit i is the tile i steps after first, bit width the tile before the scanned ones.
+			const int width			= static_cast<int>( std::min<size_t>( JUMP_SCAN_WIDTH, tile - stride + 1 ) );
+			const size_t first		= tile + 1 - width;
+			const uint64_t row		= gameState.GetBlockedBits( first, width + 1 );
+			const uint64_t above	= gameState.GetBlockedBits( first - stride, width + 1 );
+			const uint64_t below	= gameState.GetBlockedBits( first + stride, width + 1 );
+			const uint64_t scannedMask	= LowBitsMask( width );
+			uint64_t jumpPoints		= ( ( ~above & ( above >> 1 ) ) | ( ~below & ( below >> 1 ) ) ) & scannedMask;
+			if ( goalInRow && first <= goal && goal <= tile ) {
+				jumpPoints			|= uint64_t( 1 ) << ( goal - first );
+			}
+			const uint64_t blocked	= row & scannedMask;
+			if ( jumpPoints != 0 && ( blocked == 0 || HighestBitIndex( jumpPoints ) > HighestBitIndex( blocked ) ) ) {
+				return static_cast<uint32_t>( first + HighestBitIndex( jumpPoints ) );
+			}
+			if ( blocked != 0 ) {
+				return NO_JUMP_POINT;
+			}
+			tile		= first - 1;
+		}
+	}
+}
+
+uint32_t JumpPointSearch::JumpVertical( const GameState& gameState, uint32_t from, int direction, uint32_t goal ) const {
+	// A path going vertically may turn either way at any tile, so a tile is a jump point if a horizontal jump from it finds one.
+	const int step		= direction * static_cast<int>( gameState.BoardStride );
+	for ( uint32_t tile = static_cast<uint32_t>( static_cast<int>( from ) + step ); ; tile = static_cast<uint32_t>( static_cast<int>( tile ) + step ) ) {
+		if ( gameState.IsTileBlockedBit( tile ) ) {
+			return NO_JUMP_POINT;
+		}
+		if ( tile == goal || this->JumpHorizontal( gameState, tile, -1, goal ) != NO_JUMP_POINT || this->JumpHorizontal( gameState, tile, 1, goal ) != NO_JUMP_POINT ) {
+			return tile;
+		}
+	}
+}
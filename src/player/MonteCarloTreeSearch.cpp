@@ -0,0 +1,228 @@
+#include "MonteCarloTreeSearch.h"
+
+#include <chrono>
+#include <cmath>
+#include "../Game.h"
+
+#define NO_TREE_NODE			UINT32_MAX
+#define ROLLOUT_FLOW_CHANCE		3			// Out of 4, chance that a rollout move follows the apple flow field instead of a random free direction.
+#define REWARD_ALIVE			0.6f		// Reward of a snake that survives the playout, dying earns up to half of it depending on how long the snake lasted.
+#define REWARD_APPLE			0.4f		// Added for surviving snakes that grew during the playout.
+
+static double GetSeconds() {
+	return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+static Move GetMoveTowards( uint32_t fromTile, uint32_t toTile ) {
+	const int offset		= static_cast<int>( toTile ) - static_cast<int>( fromTile );
+	return offset == -1 ? Move::Left : offset == 1 ? Move::Right : offset < 0 ? Move::Up : Move::Down;
+}
+
+static uint32_t GetMoveTarget( const GameState& gameState, uint32_t headTile, Move move ) {
+	const glm::ivec2 direction		= ConvertMoveToIVec2( move );
+	return static_cast<uint32_t>( static_cast<int>( headTile ) + direction.y * static_cast<int>( gameState.BoardStride ) + direction.x );
+}
+
+MonteCarloTreeSearch::MonteCarloTreeSearch( uint64_t seed, size_t nrOfThreads, double timeBudgetMs ) : m_Pool( nrOfThreads ), m_Random( seed ), m_TimeBudgetMs( timeBudgetMs ) {
+	m_Searches.resize( MCTS_NR_OF_TREES );
+	m_Workers.resize( m_Pool.GetNrOfThreads() );
+}
+
+void MonteCarloTreeSearch::MakeMoves( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) {
+	const Team& team		= currentState.Teams[teamIndex];
+
+	// Every search starts with fresh trees and its own random numbers, drawn here so that they don't depend on which thread runs it.
+	m_SnakeSlots.assign( currentState.FreeTickOffsets.size(), NO_TREE_NODE );
+	m_StartLengths.resize( team.Snakes.size() );
+	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+		m_SnakeSlots[team.Snakes[snakeIndex].Id]		= static_cast<uint32_t>( snakeIndex );
+		m_StartLengths[snakeIndex]						= team.Snakes[snakeIndex].Segments.size() + team.Snakes[snakeIndex].SegmentsToSpawn;
+	}
+	for ( Search& search : m_Searches ) {
+		search.Nodes.assign( team.Snakes.size(), TreeNode{ { NO_TREE_NODE, NO_TREE_NODE, NO_TREE_NODE, NO_TREE_NODE }, 0, 0.0f } );
+		search.Random.SetState( m_Random.Next() );
+		search.NrOfPlayouts		= 0;
+	}
+
+	// Playouts start from a snapshot of the state, which restores faster than copying the state and leaves the flow field of each worker alone.
+	m_RootSnapshot.Capture( currentState );
+	m_Deadline		= GetSeconds() + m_TimeBudgetMs / 1000.0;
+	m_Pool.Run( m_Searches.size(), [&]( size_t searchIndex, size_t workerIndex ) {
+		this->RunSearch( currentState, teamIndex, m_Searches[searchIndex], m_Workers[workerIndex] );
+	} );
+
+	// Each snake takes the move its roots visited most in total, the visits go to the moves that did best.
+	for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+		uint32_t visits[4]		= { 0, 0, 0, 0 };
+		for ( const Search& search : m_Searches ) {
+			const TreeNode& root		= search.Nodes[snakeIndex];
+			for ( size_t moveIndex = 0; moveIndex < 4; ++moveIndex ) {
+				if ( root.Children[moveIndex] != NO_TREE_NODE ) {
+					visits[moveIndex]		+= search.Nodes[root.Children[moveIndex]].Visits;
+				}
+			}
+		}
+		size_t bestMove		= 0;
+		for ( size_t moveIndex = 1; moveIndex < 4; ++moveIndex ) {
+			if ( visits[moveIndex] > visits[bestMove] ) {
+				bestMove		= moveIndex;
+			}
+		}
+		if ( visits[bestMove] > 0 ) {
+			outMoves[snakeIndex]		= static_cast<Move>( bestMove );
+		}
+	}
+
+	for ( const Search& search : m_Searches ) {
+		m_NrOfPlayouts		+= search.NrOfPlayouts;
+	}
+}
+
+size_t MonteCarloTreeSearch::GetNrOfPlayouts() const {
+	return m_NrOfPlayouts;
+}
+
+void MonteCarloTreeSearch::RunSearch( const GameState& rootState, size_t teamIndex, Search& search, Worker& worker ) {
+	const size_t nrOfPlayouts		= MCTS_ITERATIONS_PER_TICK / MCTS_NR_OF_TREES;
+	worker.State.AppleFlow			= rootState.AppleFlow;		// The rollout policy reads it, and playouts don't change it.
+	do {
+		this->Playout( rootState, teamIndex, search, worker );
+		++search.NrOfPlayouts;
+	} while ( m_TimeBudgetMs > 0.0 ? GetSeconds() < m_Deadline : search.NrOfPlayouts < nrOfPlayouts );
+}
+
+void MonteCarloTreeSearch::Playout( const GameState& rootState, size_t teamIndex, Search& search, Worker& worker ) {
+	const size_t nrOfSnakes		= rootState.Teams[teamIndex].Snakes.size();
+	m_RootSnapshot.Restore( worker.State );
+	GameState& state			= worker.State;
+
+	// Every snake of the team starts at its root.
+	worker.Cursors.resize( nrOfSnakes );
+	worker.Paths.resize( nrOfSnakes * ( MCTS_TREE_DEPTH + 1 ) );
+	worker.PathLengths.assign( nrOfSnakes, 1 );
+	worker.Rewards.assign( nrOfSnakes, 0.0f );
+	worker.SeenTicks.assign( nrOfSnakes, 0 );
+	for ( uint32_t slot = 0; slot < nrOfSnakes; ++slot ) {
+		worker.Cursors[slot]								= slot;
+		worker.Paths[slot * ( MCTS_TREE_DEPTH + 1 )]		= slot;
+	}
+	worker.TeamMoves.resize( state.Teams.size() );
+
+	for ( uint32_t depth = 0; depth < MCTS_PLAYOUT_DEPTH && !state.Teams[teamIndex].Snakes.empty(); ++depth ) {
+		for ( size_t otherTeamIndex = 0; otherTeamIndex < state.Teams.size(); ++otherTeamIndex ) {
+			const Team& team			= state.Teams[otherTeamIndex];
+			std::vector<Move>& moves	= worker.TeamMoves[otherTeamIndex];
+			moves.resize( team.Snakes.size() );
+			for ( size_t snakeIndex = 0; snakeIndex < team.Snakes.size(); ++snakeIndex ) {
+				const Snake& snake		= team.Snakes[snakeIndex];
+				const uint32_t slot		= otherTeamIndex == teamIndex ? m_SnakeSlots[snake.Id] : NO_TREE_NODE;
+				if ( slot == NO_TREE_NODE || worker.Cursors[slot] == NO_TREE_NODE ) {
+					moves[snakeIndex]		= this->ChooseRolloutMove( state, snake, search.Random );
+					continue;
+				}
+
+				// Walk down the snakes tree. The first node that doesn't exist yet is added and ends the snakes walk, like the tree depth does.
+				const uint32_t node		= worker.Cursors[slot];
+				const Move move			= this->SelectTreeMove( state, snake, search, node, search.Random );
+				uint32_t child			= search.Nodes[node].Children[static_cast<size_t>( move )];
+				bool isLeaf				= depth + 1 == MCTS_TREE_DEPTH;
+				if ( child == NO_TREE_NODE ) {
+					child				= static_cast<uint32_t>( search.Nodes.size() );
+					search.Nodes[node].Children[static_cast<size_t>( move )]		= child;
+					search.Nodes.push_back( TreeNode{ { NO_TREE_NODE, NO_TREE_NODE, NO_TREE_NODE, NO_TREE_NODE }, 0, 0.0f } );
+					isLeaf				= true;
+				}
+				worker.Paths[slot * ( MCTS_TREE_DEPTH + 1 ) + worker.PathLengths[slot]++]		= child;
+				worker.Cursors[slot]	= isLeaf ? NO_TREE_NODE : child;
+				moves[snakeIndex]		= move;
+			}
+		}
+
+		Game::ApplyMoves( state, worker.TeamMoves, nullptr );
+
+		// Snakes that died in this tick are rewarded for how long they lasted. Their reward is final, so they are no longer looked at.
+		for ( const Snake& snake : state.Teams[teamIndex].Snakes ) {
+			worker.SeenTicks[m_SnakeSlots[snake.Id]]		= depth + 1;
+		}
+		for ( uint32_t slot = 0; slot < nrOfSnakes; ++slot ) {
+			if ( worker.SeenTicks[slot] == depth ) {
+				worker.Rewards[slot]		= 0.5f * REWARD_ALIVE * depth / MCTS_PLAYOUT_DEPTH;
+			}
+		}
+	}
+
+	// The snakes still alive are rewarded for surviving and for growing. Every reward is added to the nodes the snakes walk passed.
+	for ( const Snake& snake : state.Teams[teamIndex].Snakes ) {
+		const uint32_t slot			= m_SnakeSlots[snake.Id];
+		const bool hasGrown			= snake.Segments.size() + snake.SegmentsToSpawn > m_StartLengths[slot];
+		worker.Rewards[slot]		= hasGrown ? REWARD_ALIVE + REWARD_APPLE : REWARD_ALIVE;
+	}
+	for ( uint32_t slot = 0; slot < nrOfSnakes; ++slot ) {
+		for ( uint32_t pathIndex = 0; pathIndex < worker.PathLengths[slot]; ++pathIndex ) {
+			TreeNode& node			= search.Nodes[worker.Paths[slot * ( MCTS_TREE_DEPTH + 1 ) + pathIndex]];
+			++node.Visits;
+			node.TotalReward		+= worker.Rewards[slot];
+		}
+	}
+}
+
+Move MonteCarloTreeSearch::SelectTreeMove( const GameState& state, const Snake& snake, const Search& search, uint32_t node, Random& random ) const {
+	// Only moves that don't run into something right away are considered, unless there are none.
+	const uint32_t headTile		= static_cast<uint32_t>( state.GetTileIndex( snake.Segments[0] ) );
+	const TreeNode& parent		= search.Nodes[node];
+	Move candidates[4];
+	size_t nrOfCandidates		= 0;
+	for ( size_t moveIndex = 0; moveIndex < 4; ++moveIndex ) {
+		if ( state.IsTileWalkableAt( GetMoveTarget( state, headTile, static_cast<Move>( moveIndex ) ), state.Tick + 1 ) ) {
+			candidates[nrOfCandidates++]		= static_cast<Move>( moveIndex );
+		}
+	}
+	if ( nrOfCandidates == 0 ) {
+		return Move::Up;
+	}
+
+	// Moves that were never tried come first, in random order. After that UCB1 weighs the average reward against how rarely the move was tried.
+	size_t nrOfUntried		= 0;
+	Move untried[4];
+	for ( size_t candidateIndex = 0; candidateIndex < nrOfCandidates; ++candidateIndex ) {
+		const uint32_t child		= parent.Children[static_cast<size_t>( candidates[candidateIndex] )];
+		if ( child == NO_TREE_NODE || search.Nodes[child].Visits == 0 ) {
+			untried[nrOfUntried++]		= candidates[candidateIndex];
+		}
+	}
+	if ( nrOfUntried > 0 ) {
+		return untried[random.NextBelow( static_cast<uint32_t>( nrOfUntried ) )];
+	}
+
+	const float logVisits		= std::log( static_cast<float>( parent.Visits ) );
+	Move bestMove				= candidates[0];
+	float bestScore				= -1.0f;
+	for ( size_t candidateIndex = 0; candidateIndex < nrOfCandidates; ++candidateIndex ) {
+		const TreeNode& child		= search.Nodes[parent.Children[static_cast<size_t>( candidates[candidateIndex] )]];
+		const float score			= child.TotalReward / child.Visits + MCTS_EXPLORATION * std::sqrt( logVisits / child.Visits );
+		if ( score > bestScore ) {
+			bestScore		= score;
+			bestMove		= candidates[candidateIndex];
+		}
+	}
+	return bestMove;
+}
+
+Move MonteCarloTreeSearch::ChooseRolloutMove( const GameState& state, const Snake& snake, Random& random ) const {
+	// Mostly follow the way to the closest apple. The flow field was built for the current tick, so later in the playout it only points roughly the right way.
+	const uint32_t headTile		= static_cast<uint32_t>( state.GetTileIndex( snake.Segments[0] ) );
+	const uint32_t nextTile		= state.AppleFlow.GetNextTile( headTile );
+	if ( nextTile != NO_FLOW && nextTile != headTile && state.IsTileWalkableAt( nextTile, state.Tick + 1 ) && random.NextBelow( 4 ) < ROLLOUT_FLOW_CHANCE ) {
+		return GetMoveTowards( headTile, nextTile );
+	}
+
+	// Otherwise take the first free direction, starting from a random one.
+	const uint32_t firstMove		= random.NextBelow( 4 );
+	for ( uint32_t moveIndex = 0; moveIndex < 4; ++moveIndex ) {
+		const Move move		= static_cast<Move>( ( firstMove + moveIndex ) % 4 );
+		if ( state.IsTileWalkableAt( GetMoveTarget( state, headTile, move ), state.Tick + 1 ) ) {
+			return move;
+		}
+	}
+	return static_cast<Move>( firstMove );		// Every direction is blocked.
+}
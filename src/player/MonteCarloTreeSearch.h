@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Player.h"
+#include "../Random.h"
+#include "../StateSnapshot.h"
+#include "../WorkStealingPool.h"
+
+#define MCTS_ITERATIONS_PER_TICK	256			// Playouts per tick when there is no time budget, shared between the trees.
+#define MCTS_NR_OF_TREES			8			// Independent searches per tick, run in parallel and merged at the root. Fixed, so that the moves don't depend on the number of threads.
+#define MCTS_TREE_DEPTH				4			// Ticks covered by the trees, the playouts follow the rollout policy after that.
+#define MCTS_PLAYOUT_DEPTH			16			// Ticks simulated by each playout.
+#define MCTS_EXPLORATION			0.7f		// Weight of the exploration term of UCB1.
+
+// Plays the whole game forward from the current state with Game::ApplyMoves, every snake of every team moving at once, and counts how the snakes of the team fare.
+// Each snake of the team has a tree of its own moves, searched with UCB1, while the other snakes and the rest of each playout follow a fast rollout policy.
+// The trees of all snakes share each playout, so one playout updates them all. Several searches run in parallel on a work stealing pool, each with its own trees
+// and random numbers, and each worker thread restores a snapshot of the state into its own scratch state. Their root statistics are added up to choose the moves.
+// With a time budget the searches run until it is used up, otherwise a fixed number of playouts per tick keeps games reproducible from their seed.
+class MonteCarloTreeSearch : public Player {
+public:
+								// Zero threads uses one per hardware thread. A time budget of zero runs MCTS_ITERATIONS_PER_TICK playouts per tick.
+	explicit					MonteCarloTreeSearch			( uint64_t seed, size_t nrOfThreads = 0, double timeBudgetMs = 0.0 );
+	void						MakeMoves						( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) override;
+
+	size_t						GetNrOfPlayouts					( ) const;		// Total number of playouts run so far.
+
+private:
+	struct TreeNode {
+		uint32_t				Children[4];		// Index of the node reached by each move, indexed by Move, or NO_TREE_NODE.
+		uint32_t				Visits;
+		float					TotalReward;
+	};
+	struct Search {
+		std::vector<TreeNode>	Nodes;				// The first node of each snake is its root, in the order of the snakes of the team.
+		::Random				Random;				// Only used by the worker running the search, so no locking is needed.
+		size_t					NrOfPlayouts;
+	};
+	struct Worker {
+		GameState							State;			// Scratch copy of the current state, reused by every playout.
+		std::vector<std::vector<Move>>		TeamMoves;
+		std::vector<uint32_t>				Cursors;		// Tree node of each snake of the team in the current playout, or NO_TREE_NODE once it has left its tree.
+		std::vector<uint32_t>				Paths;			// MCTS_TREE_DEPTH + 1 nodes per snake of the team.
+		std::vector<uint32_t>				PathLengths;
+		std::vector<float>					Rewards;		// Reward of each snake of the team in the current playout.
+		std::vector<uint32_t>				SeenTicks;		// Number of playout ticks each snake of the team was seen alive after.
+	};
+
+	void						RunSearch						( const GameState& rootState, size_t teamIndex, Search& search, Worker& worker );
+	void						Playout							( const GameState& rootState, size_t teamIndex, Search& search, Worker& worker );
+	Move						SelectTreeMove					( const GameState& state, const Snake& snake, const Search& search, uint32_t node, Random& random ) const;
+	Move						ChooseRolloutMove				( const GameState& state, const Snake& snake, Random& random ) const;
+
+	WorkStealingPool			m_Pool;
+	std::vector<Search>			m_Searches;				// MCTS_NR_OF_TREES, kept between ticks so their buffers are reused.
+	std::vector<Worker>			m_Workers;				// One per thread of the pool.
+	StateSnapshot				m_RootSnapshot;			// The current state, read by every playout.
+	std::vector<uint32_t>		m_SnakeSlots;			// Per snake id, index of the snake in the team at the start of the tick, or NO_TREE_NODE for other snakes.
+	std::vector<size_t>			m_StartLengths;			// Length of each snake of the team at the start of the tick, including segments still to spawn.
+	Random						m_Random;				// Seeds the searches.
+	double						m_TimeBudgetMs;
+	double						m_Deadline				= 0.0;		// Time the searches of the current tick stop at, in seconds on the steady clock.
+	size_t						m_NrOfPlayouts			= 0;
+};
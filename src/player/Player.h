@@ -6,5 +6,13 @@
 
 class Player {
 public:
-	virtual	void			MakeMoves			( const GameState currentState, size_t teamIndex, std::vector<Move>& outMoves ) = 0;
+	virtual					~Player				( ) = default;
+							// The state is the game's own state, shared read-only by all players and only valid during the call.
+							// Players that need a mutable copy should make one with GameState::CopyTo, preferably into a state they keep between calls.
+	virtual	void			MakeMoves			( const GameState& currentState, size_t teamIndex, std::vector<Move>& outMoves ) = 0;
+							// Players that read GameState::Territory return true, Game only builds the map if some player does.
+	virtual	bool			UsesTerritory		( ) const { return false; }
+							// Players that search game trees count the states they visit and the time they spend on it, others return zero.
+	virtual	size_t			GetNrOfNodes		( ) const { return 0; }
+	virtual	double			GetSearchSeconds	( ) const { return 0.0; }
 };
@@ -0,0 +1,41 @@
+#include "SearchEvaluation.h"
+
+#include <algorithm>
+
+float TerritoryEvaluation::Evaluate( const GameState& gameState, const Snake& snake ) {
+	m_Territory.Update( gameState );
+	return static_cast<float>( m_Territory.GetSnakeArea( snake.Id ) ) + EVALUATION_APPLE_WEIGHT * static_cast<float>( m_Territory.GetSnakeApples( snake.Id ) );
+}
+
+float ReachableAreaEvaluation::Evaluate( const GameState& gameState, const Snake& snake ) {
+	const size_t headTile		= gameState.GetTileIndex( snake.Segments.front() );
+	const size_t maxCount		= EVALUATION_ROOM_PER_SEGMENT * ( snake.Segments.size() + snake.SegmentsToSpawn );
+	return static_cast<float>( m_ReachableArea.CountTailAware( gameState, headTile, gameState.Tick, maxCount ) );
+}
+
+float AppleDistanceEvaluation::Evaluate( const GameState& gameState, const Snake& snake ) {
+	const uint32_t distance		= gameState.AppleFlow.GetDistance( gameState.GetTileIndex( snake.Segments.front() ) );
+	return -static_cast<float>( std::min<uint32_t>( distance, EVALUATION_DISTANCE_CAP ) );		// NO_FLOW counts as the cap.
+}
+
+float MobilityEvaluation::Evaluate( const GameState& gameState, const Snake& snake ) {
+	const int headTile		= static_cast<int>( gameState.GetTileIndex( snake.Segments.front() ) );
+	const int stride		= static_cast<int>( gameState.BoardStride );
+	int nrOfFreeTiles		= 0;
+	for ( int offset : { -stride, -1, 1, stride } ) {
+		nrOfFreeTiles		+= gameState.IsTileWalkableAt( static_cast<size_t>( headTile + offset ), gameState.Tick + 1 ) ? 1 : 0;
+	}
+	return static_cast<float>( nrOfFreeTiles );
+}
+
+void WeightedSumEvaluation::Add( float weight, std::unique_ptr<SearchEvaluation> evaluation ) {
+	m_Evaluations.emplace_back( weight, std::move( evaluation ) );
+}
+
+float WeightedSumEvaluation::Evaluate( const GameState& gameState, const Snake& snake ) {
+	float value		= 0.0f;
+	for ( auto& evaluation : m_Evaluations ) {
+		value		+= evaluation.first * evaluation.second->Evaluate( gameState, snake );
+	}
+	return value;
+}
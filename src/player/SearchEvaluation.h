@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include "../GameState.h"
+#include "../ReachableArea.h"
+#include "../TerritoryMap.h"
+
+#define EVALUATION_APPLE_WEIGHT		8.0f		// Tiles of territory an apple in the territory is worth.
+#define EVALUATION_ROOM_PER_SEGMENT	8			// Reachable area counts stop at this many tiles per segment of the snake, more room than that is as good as endless.
+#define EVALUATION_DISTANCE_CAP		64			// Apple distances count as at most this far, so that snakes with no apple in reach still score.
+
+// Scores a state for one living snake at the leaves of a search, higher is better. The search adds the length of the snake and handles dead snakes itself,
+// so evaluations only judge the position. Not const, so that evaluations can keep their buffers between calls.
+class SearchEvaluation {
+public:
+	virtual					~SearchEvaluation	( ) = default;
+	virtual float			Evaluate			( const GameState& gameState, const Snake& snake ) = 0;
+};
+
+// Tiles the snake reaches before every other snake, plus the apples on them.
+class TerritoryEvaluation : public SearchEvaluation {
+public:
+	float					Evaluate			( const GameState& gameState, const Snake& snake ) override;
+
+private:
+	TerritoryMap			m_Territory;		// Kept apart from GameState::Territory, which Game builds for the current state only.
+};
+
+// Tiles reachable from the head of the snake, counting tiles that tails will have left by the time they are reached. Only tells pockets too small for the snake apart,
+// since the count stops once there is plenty of room.
+class ReachableAreaEvaluation : public SearchEvaluation {
+public:
+	float					Evaluate			( const GameState& gameState, const Snake& snake ) override;
+
+private:
+	ReachableArea			m_ReachableArea;
+};
+
+// Closeness of the head to an apple, as the negated distance, read from GameState::AppleFlow. A search doesn't rebuild the flow field in every state it visits,
+// so the distances are those of the current tick. Apples eaten during the search still count through the length of the snake.
+class AppleDistanceEvaluation : public SearchEvaluation {
+public:
+	float					Evaluate			( const GameState& gameState, const Snake& snake ) override;
+};
+
+// Number of tiles next to the head that are free for the next move. Snakes in corridors have a single way out, which any other snake can cut off.
+class MobilityEvaluation : public SearchEvaluation {
+public:
+	float					Evaluate			( const GameState& gameState, const Snake& snake ) override;
+};
+
+// Sum of other evaluations, each with a weight.
+class WeightedSumEvaluation : public SearchEvaluation {
+public:
+	void					Add					( float weight, std::unique_ptr<SearchEvaluation> evaluation );
+	float					Evaluate			( const GameState& gameState, const Snake& snake ) override;
+
+private:
+	std::vector<std::pair<float, std::unique_ptr<SearchEvaluation>>>	m_Evaluations;
+};